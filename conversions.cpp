@@ -75,3 +75,115 @@ void toConservationData
       }
    }
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool isPlanarState
+   ( const t_params &params
+   , t_matrices U
+){
+   for( int i = NXFIRST; i < NXLAST; i++ ){
+      for( int j = NYFIRST; j < NYLAST; j++ ){
+         if( U[3][i][j] != 0.0 || U[6][i][j] != 0.0 ) return false; // mz, bz
+      }
+   }
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool isHydroState
+   ( const t_params &params
+   , t_matrices U
+){
+   for( int i = NXFIRST; i < NXLAST; i++ ){
+      for( int j = NYFIRST; j < NYLAST; j++ ){
+         if( U[4][i][j] != 0.0 || U[5][i][j] != 0.0 || U[6][i][j] != 0.0 ) return false; // bx, by, bz
+      }
+   }
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool isUniformInY
+   ( const t_params &params
+   , t_matrices U
+){
+   for( int k = 0; k < PRB_DIM; k++ ){
+      for( int i = NXFIRST; i < NXLAST; i++ ){
+         for( int j = NYFIRST+1; j < NYLAST; j++ ){
+            if( U[k][i][j] != U[k][i][NYFIRST] ) return false;
+         }
+      }
+   }
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void copyFirstRow
+   ( const t_params &params
+   , int n
+   , t_matrices M
+){
+   for( int k = 0; k < n; k++ ){
+      for( int i = 0; i < NX; i++ ){
+         for( int j = 0; j < NY; j++ ){
+            if( j != NYFIRST ) M[k][i][j] = M[k][i][NYFIRST];
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool isMirrorSymmetricInY
+   ( const t_params &params
+   , t_matrices U
+){
+   if( params.ny%2 != 0 ) return false;
+
+   // stretched rows have to mirror too (up to the rounding of the face positions)
+   for( int j = 0; params.stretched && j < params.ny/2; j++ ){
+      if( fabs( params.dy_cell[NYFIRST+j] - params.dy_cell[NYLAST-1-j] ) > 1e-12*params.dy ) return false;
+   }
+
+   for( int k = 0; k < PRB_DIM; k++ ){
+      for( int i = NXFIRST; i < NXLAST; i++ ){
+         for( int j = 0; j < params.ny/2; j++ ){
+            if( U[k][i][NYFIRST+j] != MIRROR_PARITY_Y(k)*U[k][i][NYLAST-1-j] ) return false;
+         }
+      }
+   }
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void mirrorUpperHalf
+   ( const t_params &params
+   , int n
+   , t_matrices M
+   , bool parity
+){
+   for( int k = 0; k < n; k++ ){
+      double sign = parity ? MIRROR_PARITY_Y(k) : 1.0;
+      for( int i = 0; i < NX; i++ ){
+         for( int j = 0; j < params.ny/2; j++ ){
+            M[k][i][NYFIRST+j] = sign*M[k][i][NYLAST-1-j];
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int countAlfvenLimitedPoints
+   ( const t_params &params
+   , t_matrices U
+){
+   double bb;
+   double limit2 = params.alfven_limit*params.alfven_limit;
+   int count = 0;
+   for( int i = NXFIRST; i < NXLAST; i++ ){
+      for( int j = NYFIRST; j < NYLAST; j++ ){
+         bb = U[4][i][j]*U[4][i][j] + U[5][i][j]*U[5][i][j] + U[6][i][j]*U[6][i][j];
+         if( bb > limit2*U[0][i][j] ) count++; // B^2/rho > c^2
+      }
+   }
+   return count;
+}
@@ -1,4 +1,5 @@
 #include "mhd2d.hpp"
+#include "tilescheduler.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void divBCalculation
@@ -6,6 +7,7 @@ void divBCalculation
    , const t_params &params
    , double &maxdivb
    , double &totdivb
+   , TileScheduler *scheduler
 ){
    // indexes of x, y magnetic field elements of the state vector
    const int kbx = 4, kby = 5;
@@ -58,8 +60,13 @@ void divBCalculation
       break;
    }
 
-   // bottom boundary
-   switch( params.boundary[params.b_bottom] ){
+   // bottom boundary; on a mirror plane (y = 0 between the first row and its ghost), By is even
+   if( params.symmetry_y == Symmetry::Mirror ){
+      for( int i = NXFIRST; i < NXLAST; i++ ){
+         U[kby][i][NYFIRST-2] = U[kby][i][NYFIRST+1];
+         U[kby][i][NYFIRST-1] = U[kby][i][NYFIRST];
+      }
+   } else switch( params.boundary[params.b_bottom] ){
    case BoundaryCondition::Undefined:
       break;
    case BoundaryCondition::Periodic:
@@ -101,28 +108,52 @@ void divBCalculation
    }
 
    // find max |divb|, total |divb|
-   double divb;
-   maxdivb = 0.0;
-   totdivb = 0.0;
-   /*#ifdef OPENMP
-   // omp-id: div_b_fix:div_b:5
-   # pragma omp parallel \
-     default( shared ) \
-     private ( divb )
-
-   # pragma omp for reduction ( + : totdivb ), reduction ( max : maxdivb )
-   #endif*/
-   for( int i = nxfirst; i < nxlast; i++ ){
-      for( int j = nyfirst; j < nylast; j++ ){
-         divb = fabs( (U[kbx][i+1][j]-U[kbx][i-1][j])/(2.0*params.dx)
-                    + (U[kby][i][j+1]-U[kby][i][j-1])/(2.0*params.dy) );
-         if( divb > maxdivb ) maxdivb = divb;
-         totdivb += divb;
+   if( scheduler ){
+      // per-row sums are added up in order afterwards, so the total does not
+      // depend on how the rows were distributed between threads
+      std::vector<double> rowTotals( NX, 0.0 );
+      TileResults results{ scheduler->getThreadCount() };
+      scheduler->forTiles( nxfirst, nxlast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+         for( int i = iFirst; i < int(iLast); i++ ){
+            for( int j = nyfirst; j < nylast; j++ ){
+               double divb = fabs( (U[kbx][i+1][j]-U[kbx][i-1][j])/params.dx_central[i]
+                                 + (U[kby][i][j+1]-U[kby][i][j-1])/params.dy_central[j] );
+               results.updateMax( thread, divb );
+               rowTotals[i] += params.stretched ? params.dx_cell[i]*params.dy_cell[j]*divb : divb;
+            }
+         }
+      } );
+      maxdivb = results.getMax();
+      totdivb = 0.0;
+      for( int i = nxfirst; i < nxlast; i++ ){
+         totdivb += rowTotals[i];
+      }
+   } else {
+      double divb;
+      maxdivb = 0.0;
+      totdivb = 0.0;
+      /*#ifdef OPENMP
+      // omp-id: div_b_fix:div_b:5
+      # pragma omp parallel \
+        default( shared ) \
+        private ( divb )
+
+      # pragma omp for reduction ( + : totdivb ), reduction ( max : maxdivb )
+      #endif*/
+      for( int i = nxfirst; i < nxlast; i++ ){
+         for( int j = nyfirst; j < nylast; j++ ){
+            divb = fabs( (U[kbx][i+1][j]-U[kbx][i-1][j])/params.dx_central[i]
+                       + (U[kby][i][j+1]-U[kby][i][j-1])/params.dy_central[j] );
+            if( divb > maxdivb ) maxdivb = divb;
+            totdivb += params.stretched ? params.dx_cell[i]*params.dy_cell[j]*divb : divb;
+         }
       }
    }
 
-   // convert sum into integral
-   totdivb *= params.dx*params.dy;
+   // convert sum into integral (the stretched grid sums are weighted with the cell areas)
+   if( !params.stretched ){
+      totdivb *= params.dx*params.dy;
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -202,8 +233,13 @@ t_status divBCorrectionSOR
       break;
    }
 
-   // bottom boundary
-   switch( params.boundary[params.b_bottom] ){
+   // bottom boundary; on a mirror plane (y = 0 between the first row and its ghost), By is even
+   if( params.symmetry_y == Symmetry::Mirror ){
+      for( int i = NXFIRST; i < NXLAST; i++ ){
+         U[kby][i][NYFIRST-2] = U[kby][i][NYFIRST+1];
+         U[kby][i][NYFIRST-1] = U[kby][i][NYFIRST];
+      }
+   } else switch( params.boundary[params.b_bottom] ){
    case BoundaryCondition::Undefined:
       break;
    case BoundaryCondition::Periodic:
@@ -261,11 +297,22 @@ t_status divBCorrectionSOR
 
       for( int i = nxfirst; i < nxlast; i++ ){
          for( int j = nyfirst; j < nylast; j++ ){
-            r  = pxfac*( phi[i+2][j] /*- 2.0*phi[i][j]*/ + phi[i-2][j] );
-            r += pyfac*( phi[i][j+2] /*- 2.0*phi[i][j]*/ + phi[i][j-2] );
-            r += bxfac*( U[4][i+1][j] - U[4][i-1][j] );
-            r += byfac*( U[5][i][j+1] - U[5][i][j-1] );
-            r *= coef;
+            if( params.stretched ){
+               // the Laplacian is the central difference of the central difference, whose
+               // coefficients depend on the distances around the three points involved
+               double hx = params.dx_central[i], hy = params.dy_central[j];
+               double axp = 1.0/( hx*params.dx_central[i+1] ), axm = 1.0/( hx*params.dx_central[i-1] );
+               double ayp = 1.0/( hy*params.dy_central[j+1] ), aym = 1.0/( hy*params.dy_central[j-1] );
+               r  = axp*phi[i+2][j] + axm*phi[i-2][j] + ayp*phi[i][j+2] + aym*phi[i][j-2];
+               r += ( U[4][i+1][j] - U[4][i-1][j] )/hx + ( U[5][i][j+1] - U[5][i][j-1] )/hy;
+               r /= axp + axm + ayp + aym;
+            } else {
+               r  = pxfac*( phi[i+2][j] /*- 2.0*phi[i][j]*/ + phi[i-2][j] );
+               r += pyfac*( phi[i][j+2] /*- 2.0*phi[i][j]*/ + phi[i][j-2] );
+               r += bxfac*( U[4][i+1][j] - U[4][i-1][j] );
+               r += byfac*( U[5][i][j+1] - U[5][i][j-1] );
+               r *= coef;
+            }
 
             r -= phi[i][j];
             phi[i][j] += omega*r;
@@ -321,8 +368,13 @@ t_status divBCorrectionSOR
          break;
       }
 
-      // bottom boundary
-      switch( params.boundary[params.b_bottom] ){
+      // bottom boundary; on a mirror plane, phi is odd (like Bx)
+      if( params.symmetry_y == Symmetry::Mirror ){
+         for( int i = NXFIRST; i < NXLAST; i++ ){
+            phi[i][NYFIRST-2] = -phi[i][NYFIRST+1];
+            phi[i][NYFIRST-1] = -phi[i][NYFIRST];
+         }
+      } else switch( params.boundary[params.b_bottom] ){
       case BoundaryCondition::Undefined:
          break;
       case BoundaryCondition::Periodic:
@@ -389,10 +441,10 @@ t_status divBCorrectionSOR
    }
 
    // correct magnetic field
-   bxfac = 1.0/(2.0*params.dx);
-   byfac = 1.0/(2.0*params.dy);
    for( int i = nxfirst-1; i < nxlast+1; i++ ){
+      bxfac = 1.0/params.dx_central[i];
       for( int j = nyfirst-1; j < nylast+1; j++ ){
+         byfac = 1.0/params.dy_central[j];
          U[4][i][j] += /*bxfac**/( phi[i+1][j] - phi[i-1][j] )*bxfac;
          U[5][i][j] += /*byfac**/( phi[i][j+1] - phi[i][j-1] )*byfac;
       }
@@ -97,6 +97,8 @@ TimeStepMode fromString<TimeStepMode>
       member = TimeStepMode::Constant;
    } else if( name == "variable" ){
       member = TimeStepMode::Variable;
+   } else if( name == "error-controlled" ){
+      member = TimeStepMode::ErrorControlled;
    } else {
       member = TimeStepMode::Undefined;
    }
@@ -121,6 +123,51 @@ std::string toString<TimeStepMode>
    case TimeStepMode::Variable:
       name = "variable";
       break;
+   case TimeStepMode::ErrorControlled:
+      name = "error-controlled";
+      break;
+   }
+
+   return name;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <>
+TimeStepControl fromString<TimeStepControl>
+   ( std::string name
+){
+   TimeStepControl member;
+   std::transform( name.begin(), name.end(), name.begin(), ::tolower );
+
+   if( false ){ // just to align the ifs below
+   } else if( name == "halving" ){
+      member = TimeStepControl::Halving;
+   } else if( name == "continuous" ){
+      member = TimeStepControl::Continuous;
+   } else {
+      member = TimeStepControl::Undefined;
+   }
+
+   return member;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <>
+std::string toString<TimeStepControl>
+   ( TimeStepControl member
+){
+   std::string name;
+
+   switch( member ){
+   case TimeStepControl::Undefined:
+      name = "undefined";
+      break;
+   case TimeStepControl::Halving:
+      name = "halving";
+      break;
+   case TimeStepControl::Continuous:
+      name = "continuous";
+      break;
    }
 
    return name;
@@ -139,6 +186,12 @@ TimeStepMethod fromString<TimeStepMethod>
       member = TimeStepMethod::Euler;
    } else if( name == "rk3" ){
       member = TimeStepMethod::RungeKutta3_TVD;
+   } else if( name == "rk3-ls" ){
+      member = TimeStepMethod::RungeKutta3_TVD_LowStorage;
+   } else if( name == "ssprk43" ){
+      member = TimeStepMethod::SSPRK43;
+   } else if( name == "rk3-imex" ){
+      member = TimeStepMethod::RungeKutta3_IMEX;
    } else {
       member = TimeStepMethod::Undefined;
    }
@@ -163,6 +216,15 @@ std::string toString<TimeStepMethod>
    case TimeStepMethod::RungeKutta3_TVD:
       name = "rk3";
       break;
+   case TimeStepMethod::RungeKutta3_TVD_LowStorage:
+      name = "rk3-ls";
+      break;
+   case TimeStepMethod::SSPRK43:
+      name = "ssprk43";
+      break;
+   case TimeStepMethod::RungeKutta3_IMEX:
+      name = "rk3-imex";
+      break;
    }
 
    return name;
@@ -183,6 +245,14 @@ IntegrationMethod fromString<IntegrationMethod>
       member = IntegrationMethod::ENO_Roe;
    } else if( name == "eno-lf" ){
       member = IntegrationMethod::ENO_LF;
+   } else if( name == "eno-lf-hybrid" ){
+      member = IntegrationMethod::ENO_LF_Hybrid;
+   } else if( name == "eno-lf-componentwise" ){
+      member = IntegrationMethod::ENO_LF_Componentwise;
+   } else if( name == "weno5-lf" ){
+      member = IntegrationMethod::WENO5_LF;
+   } else if( name == "hlld" ){
+      member = IntegrationMethod::HLLD;
    } else {
       member = IntegrationMethod::Undefined;
    }
@@ -210,6 +280,18 @@ std::string toString<IntegrationMethod>
    case IntegrationMethod::ENO_LF:
       name = "eno-lf";
       break;
+   case IntegrationMethod::ENO_LF_Hybrid:
+      name = "eno-lf-hybrid";
+      break;
+   case IntegrationMethod::ENO_LF_Componentwise:
+      name = "eno-lf-componentwise";
+      break;
+   case IntegrationMethod::WENO5_LF:
+      name = "weno5-lf";
+      break;
+   case IntegrationMethod::HLLD:
+      name = "hlld";
+      break;
    }
 
    return name;
@@ -303,3 +385,45 @@ std::string toString<DivBCorrectionMethod>
 
    return name;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <>
+Symmetry fromString<Symmetry>
+   ( std::string name
+){
+   Symmetry member;
+   std::transform( name.begin(), name.end(), name.begin(), ::tolower );
+
+   if( false ){ // just to align the ifs below
+   } else if( name == "none" ){
+      member = Symmetry::None;
+   } else if( name == "mirror" ){
+      member = Symmetry::Mirror;
+   } else {
+      member = Symmetry::Undefined;
+   }
+
+   return member;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <>
+std::string toString<Symmetry>
+   ( Symmetry member
+){
+   std::string name;
+
+   switch( member ){
+   case Symmetry::Undefined:
+      name = "undefined";
+      break;
+   case Symmetry::None:
+      name = "none";
+      break;
+   case Symmetry::Mirror:
+      name = "mirror";
+      break;
+   }
+
+   return name;
+}
@@ -41,6 +41,14 @@ enum class TimeStepMode
    { Undefined
    , Constant
    , Variable
+   , ErrorControlled
+};
+
+// Time step size control in variable time stepping mode
+enum class TimeStepControl
+   { Undefined
+   , Halving
+   , Continuous
 };
 
 // Time stepping methods
@@ -48,6 +56,9 @@ enum class TimeStepMethod
    { Undefined
    , Euler
    , RungeKutta3_TVD
+   , RungeKutta3_TVD_LowStorage
+   , SSPRK43
+   , RungeKutta3_IMEX
 };
 
 // Spatial integration methods
@@ -56,6 +67,10 @@ enum class IntegrationMethod
    , CentralFD
    , ENO_Roe
    , ENO_LF
+   , ENO_LF_Hybrid
+   , ENO_LF_Componentwise
+   , WENO5_LF
+   , HLLD
 };
 
 // Boundary conditions
@@ -72,6 +87,13 @@ enum class DivBCorrectionMethod
    , SOR
 };
 
+// Symmetries of the problem
+enum class Symmetry
+   { Undefined
+   , None
+   , Mirror   // mirror symmetric about the horizontal midplane
+};
+
 template <typename T>
 T fromString
    ( std::string name );
@@ -83,8 +83,51 @@ void inputData
    // Grid size
    params.nx = readEntry<int>( pt, "problem", "Nx", 16 );
    params.ny = readEntry<int>( pt, "problem", "Ny", 16 );
+   params.dimensions = readEntry<int>( pt, "problem", "dimensions", 0 );
+   if( params.dimensions < 0 || params.dimensions > 2 ){
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "inputData: in section [problem], key \"dimensions\":\n"
+                   + "Must be 1, 2, or 0 (detect)." );
+   }
+   tempstr = readEntry<std::string>( pt, "problem", "symmetry y", "none" );
+   params.symmetry_y = fromString<Symmetry>( tempstr );
+   if( params.symmetry_y == Symmetry::Undefined ){
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "inputData: in section [problem], key \"symmetry y\":\n"
+                   + "Unknown symmetry: " + tempstr );
+   }
+
+   // Refined patch: rows where rho, p or |B| change by more than the relative threshold between
+   // neighbouring points, plus a margin, are integrated on a grid with half the spacing
+   params.refine           = readEntry<bool>  ( pt, "problem", "refine",           false );
+   params.refine_threshold = readEntry<double>( pt, "problem", "refine threshold", 0.1   );
+   params.refine_margin    = readEntry<int>   ( pt, "problem", "refine margin",    2     );
+   params.refine_steps     = readEntry<int>   ( pt, "problem", "refine steps",     8     );
+   if( params.refine_threshold <= 0.0 || params.refine_margin < 0 || params.refine_steps < 1 ){
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "inputData: in section [problem], keys \"refine threshold\", \"refine margin\", \"refine steps\":\n"
+                   + "Threshold and steps must be positive, and margin must not be negative." );
+   }
+
+   // Space integration method
+   tempstr = readEntry<std::string>( pt, "problem", "space method", "eno-roe" );
+   params.scheme = fromString<IntegrationMethod>( tempstr );
+   if( params.scheme == IntegrationMethod::Undefined ){
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "inputData: in section [problem], key \"space method\":\n"
+                   + "Unknown space integration method: " + tempstr );
+   }
+
+   // Order of the ENO reconstruction of eno-roe and the eno-lf methods
+   params.eno_order = readEntry<int>( pt, "problem", "eno order", 2 );
+   if( params.eno_order < 2 || params.eno_order > 4 ){
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "inputData: in section [problem], key \"eno order\":\n"
+                   + "Must be 2, 3 or 4." );
+   }
 
-   // Prepare data storage
+   // Prepare data storage, with the buffers the stencils of the space method need
+   params.buffer_width = requiredBufferWidth( params );
    data.U = createMatrices( PRB_DIM, NX, NY );
    data.u = createMatrices( VEL_DIM, NX, NY );
    data.p = createMatrix( NX, NY );
@@ -99,7 +142,8 @@ void inputData
 
    // Time stepping mode
    // - keep a constant dt, or
-   // - automatically change dt to satisfy CFL condition
+   // - automatically change dt to satisfy CFL condition, or
+   // - additionally keep the estimated time integration error below a tolerance
    tempstr = readEntry<std::string>( pt, "time", "mode", "constant" );
    params.time_mode = fromString<TimeStepMode>( tempstr );
    switch( params.time_mode ){
@@ -112,12 +156,50 @@ void inputData
       params.steps  = readEntry<int>   ( pt, "time", "steps", 8     );
       params.dt_max = readEntry<double>( pt, "time", "dt",    0.125 );
       params.cfl_number = double{ 0.0 };
+      params.dt_control = TimeStepControl::Halving;
+      params.local_bands  = 1;
+      params.local_levels = 0;
       break;
    case TimeStepMode::Variable:
+   case TimeStepMode::ErrorControlled:
       params.cfl_number = readEntry<double>( pt, "time", "cfl number", 0.5 );
       params.dt_max     = readEntry<double>( pt, "time", "dt_max",     1.0 );
       params.dt_min     = readEntry<double>( pt, "time", "dt_min",     params.dt_max/16.0 );
       params.t_max      = readEntry<double>( pt, "time", "t_max",      1.0 );
+
+      // local time stepping: bands of rows with their own time steps
+      params.local_bands  = 1;
+      params.local_levels = 0;
+      if( params.time_mode == TimeStepMode::Variable ){
+         params.local_bands  = readEntry<int>( pt, "time", "local bands",  1 );
+         params.local_levels = readEntry<int>( pt, "time", "local levels", 3 );
+         if( params.local_bands < 1 || params.local_levels < 0 ){
+            criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                         + "inputData: in section [time], keys \"local bands\", \"local levels\":\n"
+                         + "Band count must be positive, and level count must not be negative." );
+         }
+      }
+
+      tempstr = readEntry<std::string>( pt, "time", "dt control"
+                                      , params.time_mode == TimeStepMode::ErrorControlled
+                                        || params.local_bands > 1 ? "continuous" : "halving" );
+      params.dt_control = fromString<TimeStepControl>( tempstr );
+      if( params.dt_control == TimeStepControl::Undefined ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "inputData: in section [time], key \"dt control\":\n"
+                      + "Unknown time step control: " + tempstr );
+      }
+
+      if( params.time_mode == TimeStepMode::ErrorControlled ){
+         params.error_tolerance     = readEntry<double>( pt, "time", "tolerance",          1.0e-4 );
+         params.error_tolerance_abs = readEntry<double>( pt, "time", "absolute tolerance", params.error_tolerance );
+         if( params.error_tolerance < 0.0 || params.error_tolerance_abs < 0.0
+             || params.error_tolerance + params.error_tolerance_abs == 0.0 ){
+            criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                         + "inputData: in section [time], keys \"tolerance\", \"absolute tolerance\":\n"
+                         + "Tolerances must not be negative, and at least one must be positive." );
+         }
+      }
       break;
    }
 
@@ -149,6 +231,14 @@ void inputData
    // Negative pressure handling
    params.break_on_neg_pressure = readEntry<bool>( pt, "problem", "halt on negative pressure", false );
 
+   // Alfven speed limit (Boris correction), 0 for none
+   params.alfven_limit = readEntry<double>( pt, "problem", "alfven speed limit", 0.0 );
+   if( params.alfven_limit < 0.0 ){
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "inputData: in section [problem], key \"alfven speed limit\":\n"
+                   + "Alfven speed limit must not be negative" );
+   }
+
    // Time integration method
    tempstr = readEntry<std::string>( pt, "problem", "time method", "rk3" );
    params.time_stepping = fromString<TimeStepMethod>( tempstr );
@@ -158,13 +248,74 @@ void inputData
                    + "Unknown time stepping method: " + tempstr );
    }
 
-   // Space integration method
-   tempstr = readEntry<std::string>( pt, "problem", "space method", "eno-roe" );
-   params.scheme = fromString<IntegrationMethod>( tempstr );
-   if( params.scheme == IntegrationMethod::Undefined ){
+   // Semi-implicit fast waves of rk3-imex
+   if( params.time_stepping == TimeStepMethod::RungeKutta3_IMEX ){
+      params.imex_cfl_factor = readEntry<double>( pt, "time", "imex cfl factor", 4.0    );
+      params.imex_tolerance  = readEntry<double>( pt, "time", "imex tolerance",  1.0e-6 );
+      params.imex_iterations = readEntry<int>   ( pt, "time", "imex iterations", 100    );
+      if( params.imex_cfl_factor < 1.0 || params.imex_tolerance <= 0.0 || params.imex_iterations < 1 ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "inputData: in section [time], keys \"imex cfl factor\", \"imex tolerance\", \"imex iterations\":\n"
+                      + "CFL factor must be at least 1, tolerance and iteration limit must be positive." );
+      }
+   }
+
+   // Reduced system (without mz and bz, or without B), if the initial state allows it
+   params.reduced_system = readEntry<bool>( pt, "problem", "reduced system", true );
+
+   // Copy the numerical fluxes of uniform regions instead of computing them, if supported
+   params.skip_uniform = readEntry<bool>( pt, "problem", "skip uniform", true );
+
+   // Reuse the eigensystems of repeated state pairs instead of computing them, if supported
+   params.cache_eigensystems = readEntry<bool>( pt, "problem", "cache eigensystems", true );
+
+   // Discontinuity detector of eno-lf-hybrid
+   params.hybrid_threshold = readEntry<double>( pt, "problem", "hybrid threshold", 0.01 );
+
+   // Lax-Friedrichs viscosity of the eno-lf methods from the eigenvalues of each face
+   // instead of the largest ones of its row or column
+   params.local_viscosity = readEntry<bool>( pt, "problem", "local viscosity", false );
+
+   // Parallelization: worker threads and tile size (in grid columns) for tiled loops
+   params.threads   = readEntry<int>( pt, "parallel", "threads",   1 );
+   params.tile_size = readEntry<int>( pt, "parallel", "tile size", 8 );
+   if( params.threads < 1 || params.tile_size < 1 ){
       criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
-                   + "inputData: in section [problem], key \"space method\":\n"
-                   + "Unknown space integration method: " + tempstr );
+                   + "inputData: in section [parallel]:\n"
+                   + "Thread count and tile size must be positive" );
+   }
+
+   // Thread pinning: thread t runs on the t-th CPU of the list (e.g. "0-3,8-11"),
+   // or on CPU t if the list is empty
+   params.pin_threads = readEntry<bool>( pt, "parallel", "pin threads", false );
+   params.cpu_list.clear();
+   if( params.pin_threads ){
+      tempstr = readEntry<std::string>( pt, "parallel", "cpu list", "" );
+      std::vector<std::string> cpuRanges;
+      boost::split( cpuRanges, tempstr, boost::is_any_of( "," ) );
+      for( auto &cpuRange: cpuRanges ){
+         boost::trim( cpuRange );
+         if( cpuRange.empty() ) continue;
+         int first, last;
+         char dash;
+         std::istringstream rangeStream( cpuRange );
+         if( rangeStream >> first ){
+            last = first;
+            if( rangeStream >> dash ){
+               if( dash != '-' || !( rangeStream >> last ) ) first = -1;
+            }
+         } else {
+            first = -1;
+         }
+         if( first < 0 || last < first || !rangeStream.eof() ){
+            criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                         + "inputData: in section [parallel], key \"cpu list\":\n"
+                         + "Invalid CPU or CPU range: " + cpuRange );
+         }
+         for( auto cpu = first; cpu <= last; cpu++ ){
+            params.cpu_list.push_back( cpu );
+         }
+      }
    }
 
    // Data output file
@@ -262,6 +413,7 @@ void inputData
    params.log_params.r_end             = readEntry<bool>( pt, "logging", "phi correction final",   false );
    params.log_params.divb_step         = readEntry<bool>( pt, "logging", "divb correction",        false );
    params.log_params.characteristics   = readEntry<bool>( pt, "logging", "characteristics",        false );
+   params.log_params.alfven_limit      = readEntry<bool>( pt, "logging", "alfven limiter",         false );
 
    // Create the hint file that records the binary file structure
    if( output_grid.binary ){
@@ -298,6 +450,125 @@ void readParamsDivBCorrector
    params.divb_skip_steps = readEntry<int>( pt, "divb corrector", "stepping rate", 1 );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* First of the points [first,last) at or after coordinate x, or last if there is none */
+static int firstPointAt
+   ( const t_vector point
+   , int    first
+   , int    last
+   , double x
+){
+   int i = first;
+   while( i < last && point[i] < x ) i++;
+   return i;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Cell widths, distances between neighbours and point coordinates along one axis of n points
+   (plus buffer ghost points on both sides) with the first point at start; returns true if the
+   spacing is not uniform */
+static bool readGridAxis
+   ( boost::property_tree::ptree &pt
+   , const std::string &axis
+   , int      n
+   , int      buffer
+   , double   start
+   , double   length
+   , double   spacing
+   , t_vector width
+   , t_vector central
+   , t_vector point
+){
+   const int first = buffer, last = n+buffer, total = n+2*buffer;
+
+   // the grid covers the same interval as the uniform grid
+   double lower = start - 0.5*spacing;
+
+   auto tempstr = readEntry<std::string>( pt, "problem", "stretch "+axis, "none" );
+   if( tempstr == "none" ){
+      for( int i = 0; i < total; i++ ){
+         width[i] = spacing;
+         point[i] = start + (i-first)*spacing;
+      }
+   } else if( tempstr == "tanh" ){
+      // relative spacing 1 at the center, growing to ratio over a few widths from it; the faces
+      // are at equal steps of the integral of 1/spacing, tabulated on a finer grid
+      double center = readEntry<double>( pt, "problem", "stretch "+axis+" center", lower+0.5*length );
+      double scale  = readEntry<double>( pt, "problem", "stretch "+axis+" width",  length/8.0       );
+      double ratio  = readEntry<double>( pt, "problem", "stretch "+axis+" ratio",  4.0              );
+      if( scale <= 0.0 || ratio < 1.0 ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "readGridAxis: in section [problem], keys \"stretch " + axis + " width\", \"stretch " + axis + " ratio\":\n"
+                      + "Width must be positive, and ratio at least 1." );
+      }
+      auto density = [&]( double x ){
+         double t = tanh( (x-center)/scale );
+         return 1.0/( 1.0 + (ratio-1.0)*t*t );
+      };
+
+      const int samples = 64*n;
+      std::vector<double> integral( samples+1, 0.0 );
+      double h = length/samples;
+      for( int m = 1; m <= samples; m++ ){
+         integral[m] = integral[m-1] + 0.5*h*( density( lower+(m-1)*h ) + density( lower+m*h ) );
+      }
+
+      double face = lower;
+      int m = 0;
+      for( int k = 1; k <= n; k++ ){
+         double next = lower+length;
+         if( k < n ){
+            double target = integral[samples]*k/n;
+            while( integral[m+1] < target ) m++;
+            next = lower + h*( m + (target-integral[m])/(integral[m+1]-integral[m]) );
+         }
+         width[first+k-1] = next-face;
+         point[first+k-1] = face + 0.5*(next-face);
+         face = next;
+      }
+
+      // ghost cells mirror the cells next to the boundary
+      for( int g = 0; g < first; g++ ){
+         width[first-1-g] = width[first+g];
+         width[last+g]    = width[last-1-g];
+         point[first-1-g] = point[first-g]  - 0.5*( width[first-g]  + width[first-1-g] );
+         point[last+g]    = point[last-1+g] + 0.5*( width[last-1+g] + width[last+g]    );
+      }
+   } else {
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "readGridAxis: in section [problem], key \"stretch " + axis + "\":\n"
+                   + "Unknown grid stretching: " + tempstr );
+   }
+
+   // on a uniform grid, this is exactly 2*spacing
+   central[0]       = 2.0*width[0];
+   central[total-1] = 2.0*width[total-1];
+   for( int i = 1; i < total-1; i++ ){
+      central[i] = 0.5*( width[i-1] + width[i+1] ) + width[i];
+   }
+
+   return tempstr != "none";
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void readGrid
+   ( boost::property_tree::ptree &pt
+   , t_params &params
+   , double    Lx
+   , double    Ly
+){
+   params.dx_cell    = createVector( NX );
+   params.dy_cell    = createVector( NY );
+   params.dx_central = createVector( NX );
+   params.dy_central = createVector( NY );
+   params.x_point    = createVector( NX );
+   params.y_point    = createVector( NY );
+
+   auto stretched_x = readGridAxis( pt, "x", params.nx, NXFIRST, params.start_x, Lx, params.dx, params.dx_cell, params.dx_central, params.x_point );
+   auto stretched_y = readGridAxis( pt, "y", params.ny, NYFIRST, params.start_y, Ly, params.dy, params.dy_cell, params.dy_central, params.y_point );
+   params.stretched = stretched_x || stretched_y;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void readProblemShockTube
    ( boost::property_tree::ptree &pt
@@ -311,6 +582,7 @@ void readProblemShockTube
    double Ly = readEntry<double>( pt, "problem", "Ly", 2.0 ); params.dy = Ly/params.ny;
    params.start_x = readEntry<double>( pt, "problem", "start_x", -1.0 );
    params.start_y = readEntry<double>( pt, "problem", "start_y", -1.0 );
+   readGrid( pt, params, Lx, Ly );
 
    // Shock tube angle to the x-axis
    double angle = readEntry<double>( pt, "problem", "interface angle", 0.0 );
@@ -346,6 +618,12 @@ void readProblemShockTube
       int jump = line_j < NYFIRST ? NYFIRST :
                  line_j > NYLAST  ? NYLAST  :
                                     line_j;
+      if( params.stretched ){
+         // first cell with its bottom face above the interface
+         line_y = params.start_y + y0 - slope*( params.x_point[i] - params.start_x - x0 );
+         jump = NYFIRST;
+         while( jump < NYLAST && params.y_point[jump] - 0.5*params.dy_cell[jump] < line_y ) jump++;
+      }
       for( int j = NYFIRST; j < jump; j++ ){
          data.U[0][i][j] = left[0];
          data.u[0][i][j] = left[1];
@@ -407,6 +685,7 @@ void readProblemExplosion
    double Ly = readEntry<double>( pt, "problem", "Ly", 2.0 ); params.dy = Ly/params.ny;
    params.start_x = readEntry<double>( pt, "problem", "start_x", -1.0 );
    params.start_y = readEntry<double>( pt, "problem", "start_y", -1.0 );
+   readGrid( pt, params, Lx, Ly );
 
    // give meaningful names
    t_matrix U_rho = data.U[0];
@@ -424,6 +703,11 @@ void readProblemExplosion
 
    double r = readEntry<double>( pt, "problem", "r",       0.4   );
    auto is_inside = [&params, &r]( size_t i, size_t j ){
+      if( params.stretched ){
+         double x = params.x_point[i] - params.x_point[NX/2];
+         double y = params.y_point[j] - params.y_point[NY/2];
+         return x*x + y*y < r*r;
+      }
       return (i-NX/2)*(i-NX/2)*params.dx*params.dx + (j-NY/2)*(j-NY/2)*params.dy*params.dy < r*r;
    };
 
@@ -589,11 +873,12 @@ void readProblemOTVortex
    double y0 = readEntry<double>( pt, "problem", "y0 percent", 0.0 );
    params.start_x = x0*2.0*M_PI;
    params.start_y = y0*2.0*M_PI;
+   readGrid( pt, params, Lx, Ly );
 
    for( int i = NXFIRST; i < NXLAST; i++ ){
       for( int j = NYFIRST; j < NYLAST; j++ ){
-         x       = params.start_x + (i-NXFIRST)*params.dx;
-         y       = params.start_y + (j-NYFIRST)*params.dy;
+         x       = params.x_point[i];
+         y       = params.y_point[j];
 
          /* rho */ data.U[0][i][j] = params.gamma*params.gamma;
          /*  u  */ data.u[0][i][j] = -sin(y);
@@ -625,6 +910,7 @@ void readProblemPlasmaSheet
    double Ly = readEntry<double>( pt, "problem", "Ly", 2.0 ); params.dy = Ly/params.ny;
    params.start_x = readEntry<double>( pt, "problem", "start_x", 0.0 );
    params.start_y = readEntry<double>( pt, "problem", "start_y", 0.0 );
+   readGrid( pt, params, Lx, Ly );
 
    std::vector<t_matrix> U_natural = { data.U[0], data.u[0], data.u[1], data.u[2], data.U[4], data.U[5], data.U[6], data.p };
    t_matrix U_rho = data.U[0];
@@ -692,11 +978,24 @@ void readProblemPlasmaSheet
    double ellip_b2 = ellip_b*ellip_b;
    double ellip_x, ellip_y;
    for( int j = dnlimit; j < uplimit; j++ ){
-      ellip_y = (j-1.5) * params.dy - Ly/2;
+      ellip_y = (j-NYFIRST+0.5) * params.dy - Ly/2;
       ellip_x = sheet_start_foot + ellip_a*sqrt( 1.0 - (ellip_y*ellip_y/ellip_b2) );
       sheet_start_index[j] = (-params.start_x+ellip_x)/params.dx + NXFIRST;
    }
 
+   // on a stretched grid, the lobes are the rows with their points outside the sheet, and the
+   // sheet starts at the first point at or after the ellipse
+   if( params.stretched ){
+      double lower_y = params.start_y - 0.5*params.dy;
+      dnlimit = firstPointAt( params.y_point, NYFIRST, NYLAST, lower_y + 0.5*(Ly-sheet_thickness) );
+      uplimit = firstPointAt( params.y_point, NYFIRST, NYLAST, lower_y + 0.5*(Ly+sheet_thickness) );
+      for( int j = dnlimit; j < uplimit; j++ ){
+         ellip_y = params.y_point[j] - ( lower_y + 0.5*Ly );
+         ellip_x = sheet_start_foot + ellip_a*sqrt( std::max( 0.0, 1.0 - (ellip_y*ellip_y/ellip_b2) ) );
+         sheet_start_index[j] = firstPointAt( params.x_point, NXFIRST, NXLAST, ellip_x );
+      }
+   }
+
    std::string sheet_profile = readEntry<std::string>( pt, "problem", "sheet profile", "constant" );
 
    if( sheet_profile == "constant" ){
@@ -761,6 +1060,10 @@ void readProblemPlasmaSheet
          for( int j = dnlimit; j < uplimit; j++ ){
             // tanh(y) profile for B, with -1 <= y <= 1
             double coef_b = tanh( 2.0*(j-dnlimit)/((uplimit-1)-dnlimit) - 1.0 );
+            if( params.stretched ){
+               coef_b = tanh( 2.0*(params.y_point[j]-params.y_point[dnlimit])
+                              /(params.y_point[uplimit-1]-params.y_point[dnlimit]) - 1.0 );
+            }
 
             if( i < sheet_start_index[j] ){
                U_rho[i][j] = left[0];
@@ -929,6 +1232,7 @@ void readProblemWaveTest
    auto Ly = readEntry<double>( pt, "problem", "Ly", 1.0 ); params.dy = Ly/params.ny;
    params.start_x = readEntry<double>( pt, "problem", "start_x", -0.5 );
    params.start_y = readEntry<double>( pt, "problem", "start_y", -0.5 );
+   readGrid( pt, params, Lx, Ly );
 
    // give meaningful names
    t_matrix U_rho = data.U[0];
@@ -1020,8 +1324,8 @@ void readProblemWaveTest
    for( auto k = size_t{0}; k < PRB_DIM; k++ ){
       for( auto i = NXFIRST; i < NXLAST; i++ ){
          for( auto j = NYFIRST; j < NYLAST; j++ ){
-            x = params.start_x + (i-NXFIRST)*params.dx;
-            y = params.start_y + (j-NYFIRST)*params.dy;
+            x = params.x_point[i];
+            y = params.y_point[j];
             data.U[k][i][j] = U_con_avg[k]
                             + epsilon*eigenvector[k]*std::cos( scale_x*wavenumber_x*x + scale_y*wavenumber_y*y );
          }
@@ -1244,15 +1548,15 @@ void outputGridDataBinary
             // calculate divb
             if( ( i >= divb_nxfirst && i < divb_nxlast ) &&
                 ( j >= divb_nyfirst && j < divb_nylast ) ){
-               divb = fabs( (U[kbx][i+1][j]-U[kbx][i-1][j])/(2.0*params.dx)
-                          + (U[kby][i][j+1]-U[kby][i][j-1])/(2.0*params.dy) );
+               divb = fabs( (U[kbx][i+1][j]-U[kbx][i-1][j])/params.dx_central[i]
+                          + (U[kby][i][j+1]-U[kby][i][j-1])/params.dy_central[j] );
             } else {
                divb = 0.0;
             }
 
             // fill record
-            records_double[ri++] = params.start_x + (i-NXFIRST)*params.dx;
-            records_double[ri++] = params.start_y + (j-NYFIRST)*params.dy;
+            records_double[ri++] = params.x_point[i];
+            records_double[ri++] = params.y_point[j];
             records_double[ri++] = U[0][i][j];     // rho
             if( local_output.natural ){
                records_double[ri++] = u[0][i][j];  // u
@@ -1282,15 +1586,15 @@ void outputGridDataBinary
             // calculate divb
             if( ( i >= divb_nxfirst && i < divb_nxlast ) &&
                 ( j >= divb_nyfirst && j < divb_nylast ) ){
-               divb = fabs( (U[kbx][i+1][j]-U[kbx][i-1][j])/(2.0*params.dx)
-                          + (U[kby][i][j+1]-U[kby][i][j-1])/(2.0*params.dy) );
+               divb = fabs( (U[kbx][i+1][j]-U[kbx][i-1][j])/params.dx_central[i]
+                          + (U[kby][i][j+1]-U[kby][i][j-1])/params.dy_central[j] );
             } else {
                divb = 0.0;
             }
 
             // fill record
-            records_float[ri++] = params.start_x + (i-NXFIRST)*params.dx;
-            records_float[ri++] = params.start_y + (j-NYFIRST)*params.dy;
+            records_float[ri++] = params.x_point[i];
+            records_float[ri++] = params.y_point[j];
             records_float[ri++] = U[0][i][j];     // rho
             if( local_output.natural ){
                records_float[ri++] = u[0][i][j];  // u
@@ -1367,8 +1671,8 @@ void outputCharacteristicsBinary
       for( int i = NXFIRST; i < NXLAST; i++ ){
          for( int j = NYFIRST; j < NYLAST; j++ ){
             // fill record
-            records_double[ri++] = params.start_x + (i-NXFIRST)*params.dx;
-            records_double[ri++] = params.start_y + (j-NYFIRST)*params.dy;
+            records_double[ri++] = params.x_point[i];
+            records_double[ri++] = params.y_point[j];
 
             records_double[ri++] = cx[3][i][j];               // u
             records_double[ri++] = cy[3][i][j];               // v
@@ -1405,8 +1709,8 @@ void outputCharacteristicsBinary
       for( int i = NXFIRST; i < NXLAST; i++ ){
          for( int j = NYFIRST; j < NYLAST; j++ ){
             // fill record
-            records_float[ri++] = params.start_x + (i-NXFIRST)*params.dx;
-            records_float[ri++] = params.start_y + (j-NYFIRST)*params.dy;
+            records_float[ri++] = params.x_point[i];
+            records_float[ri++] = params.y_point[j];
 
             records_float[ri++] = cx[3][i][j];               // u
             records_float[ri++] = cy[3][i][j];               // v
@@ -1486,15 +1790,15 @@ void outputGridDataText
       for( int j = NYFIRST; j < NYLAST; j++ ){
          if( ( i >= divb_nxfirst && i < divb_nxlast ) &&
              ( j >= divb_nyfirst && j < divb_nylast ) ){
-            divb = fabs( (U[kbx][i+1][j]-U[kbx][i-1][j])/(2.0*params.dx)
-                       + (U[kby][i][j+1]-U[kby][i][j-1])/(2.0*params.dy) );
+            divb = fabs( (U[kbx][i+1][j]-U[kbx][i-1][j])/params.dx_central[i]
+                       + (U[kby][i][j+1]-U[kby][i][j-1])/params.dy_central[j] );
          } else {
             divb = 0.0;
          }
          fprintf( output.file, "%d\t%d\t%+.5e\t%+.5e\t%+.5e",
                   i-NXFIRST, j-NYFIRST,
-                  params.start_x + (i-NXFIRST)*params.dx, // x
-                  params.start_y + (j-NYFIRST)*params.dy, // y
+                  params.x_point[i], // x
+                  params.y_point[j], // y
                   U[0][i][j]      // rho
          );
          if( output.natural )
@@ -1702,18 +2006,22 @@ void outputNonGridData
             + u[2][i][j]*u[2][i][j];
          if( uu > uumax ) uumax = uu;
 
+         // on a stretched grid, the sums are weighted with the cell areas
+         double area = params.stretched ? params.dx_cell[i]*params.dy_cell[j] : 1.0;
          entropy = log( p[i][j]*pow( U[0][i][j], -params.gamma ) );
-         totentropy  += entropy;
-         totenergy   += U[7][i][j];
-         totmass     += U[0][i][j];
-         totmomentum += U[0][i][j]*sqrt(uu);
+         totentropy  += area*entropy;
+         totenergy   += area*U[7][i][j];
+         totmass     += area*U[0][i][j];
+         totmomentum += area*U[0][i][j]*sqrt(uu);
       }
    }
    // convert sums into integrals
-   totentropy  *= params.dx*params.dy;
-   totenergy   *= params.dx*params.dy;
-   totmass     *= params.dx*params.dy;
-   totmomentum *= params.dx*params.dy;
+   if( !params.stretched ){
+      totentropy  *= params.dx*params.dy;
+      totenergy   *= params.dx*params.dy;
+      totmass     *= params.dx*params.dy;
+      totmomentum *= params.dx*params.dy;
+   }
 
    // find max |divb|, integral |divb|
    double maxdivb = 0.0, totdivb = 0.0;
@@ -14,6 +14,14 @@ void readParamsDivBCorrector
    ( boost::property_tree::ptree &pt
    , t_params &params );
 
+// Read settings from property tree: grid spacing and point coordinates, for a domain of size
+// Lx x Ly with the first point at start_x, start_y
+void readGrid
+   ( boost::property_tree::ptree &pt
+   , t_params &params
+   , double    Lx
+   , double    Ly );
+
 // Read settings from property tree: Shock tube problem
 void readProblemShockTube
    ( boost::property_tree::ptree &pt
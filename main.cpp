@@ -24,9 +24,15 @@
 #include "spatialmethodcentralfd2.hpp"
 #include "spatialmethodenoroe.hpp"
 #include "spatialmethodenolf.hpp"
+#include "spatialmethodhlld.hpp"
 
 #include "timeintegrationeuler.hpp"
 #include "timeintegrationrk3.hpp"
+#include "timeintegrationrk3local.hpp"
+#include "timeintegrationrk3refined.hpp"
+#include "timeintegrationrk3ls.hpp"
+#include "timeintegrationssprk43.hpp"
+#include "timeintegrationrk3imex.hpp"
 
 #ifdef USE_THREAD_EXCEPTIONS
 /// http://stackoverflow.com/questions/11828539/elegant-exceptionhandling-in-openmp
@@ -113,29 +119,163 @@ int main
    outputGridData( output_grid, params, data, 0, 0 );
    outputNonGridData( output_non_grid, params, data, 0, 0 );
 
-   // Spatial integrator
-   auto bufferWidth = size_t{NXFIRST};
+   // Spatial integrator; eno-lf integrates a reduced system if the initial state allows it:
+   // the Euler equations if B = 0, or the system without mz and bz if w = Bz = 0, as then
+   // no boundary condition (Dirichlet values are taken from the initial state) or flux can
+   // create them
+   auto enoLF = params.scheme == IntegrationMethod::ENO_LF || params.scheme == IntegrationMethod::ENO_LF_Hybrid
+             || params.scheme == IntegrationMethod::ENO_LF_Componentwise || params.scheme == IntegrationMethod::WENO5_LF;
+   auto enoSystem = EnoSystem::MHD;
+   if( params.reduced_system && enoLF ){
+      if( isHydroState( params, data.U ) ){
+         enoSystem = EnoSystem::Hydro;
+         OUT << "Integrating the Euler equations (B = 0).\n";
+      } else if( isPlanarState( params, data.U ) ){
+         enoSystem = EnoSystem::Planar;
+         OUT << "Integrating the reduced system without mz and bz (w = Bz = 0).\n";
+      }
+   }
+   // Problems uniform in y are integrated in one dimension: the time integrator and the spatial
+   // method only get the first row of the grid (U[k][i] holds a column), which is copied to the
+   // other rows for output; activeParams describes that grid
+   auto oneDimensional = false;
+   if( params.dimensions != 2 && params.ny > 1 && isUniformInY( params, data.U ) ){
+      oneDimensional = params.dimensions == 1
+                    || ( params.scheme != IntegrationMethod::CentralFD && params.local_bands <= 1 );
+   } else if( params.dimensions == 1 && params.ny > 1 ){
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "main: One-dimensional integration requires an initial state uniform in y." );
+   }
+   auto activeParams = params;
+   if( oneDimensional ){
+      activeParams.ny = 1;
+      OUT << "Integrating in one dimension (uniform in y).\n";
+   }
+   // Problems mirror symmetric about the middle of the grid in y are integrated on the upper
+   // half only: the active arrays are views into the full arrays shifted by ny/2 rows, the
+   // mirror plane is the bottom boundary, and the lower half is filled in for output
+   auto mirror = params.symmetry_y == Symmetry::Mirror && !oneDimensional;
+   if( mirror ){
+      if( !isMirrorSymmetricInY( params, data.U ) ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "main: Mirror symmetry in y requires even Ny and an initial state (and grid) mirror symmetric in y." );
+      }
+      activeParams.ny = params.ny/2;
+      // rows of the upper half, as in the views below
+      activeParams.dy_cell    = params.dy_cell    + params.ny/2;
+      activeParams.dy_central = params.dy_central + params.ny/2;
+      activeParams.y_point    = params.y_point    + params.ny/2;
+      OUT << "Integrating the upper half (mirror symmetry in y).\n";
+   }
+   auto activeU   = createMatricesView( data.U,   PRB_DIM, NX, mirror ? params.ny/2 : 0 );
+   auto activeCx  = createMatricesView( data.cx,  PRB_DIM, NX, mirror ? params.ny/2 : 0 );
+   auto activeCy  = createMatricesView( data.cy,  PRB_DIM, NX, mirror ? params.ny/2 : 0 );
+   auto activeLUx = createMatricesView( data.LUx, PRB_DIM, NX, mirror ? params.ny/2 : 0 );
+   auto activeLUy = createMatricesView( data.LUy, PRB_DIM, NX, mirror ? params.ny/2 : 0 );
+   auto bufferWidth = requiredBufferWidth( params );
    auto boundary = t_boundary{ params.boundary[params.b_right]
                              , params.boundary[params.b_top]
                              , params.boundary[params.b_left]
                              , params.boundary[params.b_bottom] };
-   auto method_ptr = std::unique_ptr<SpatialIntegrationMethod>{};
+   auto lfViscosity = params.local_viscosity ? EnoLFViscosity::Local : EnoLFViscosity::Row;
+   auto createMethod = [&]( int nx, int ny, double dx, double dy ){
+      auto method = std::unique_ptr<SpatialIntegrationMethod>{};
+      switch( params.scheme ){
+      case IntegrationMethod::Undefined:
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "main: Unknown space integration method." );
+      case IntegrationMethod::CentralFD:
+         method = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodCentralFD2( nx, ny, bufferWidth, dx, dy, boundary, params.gamma ) };
+         break;
+      case IntegrationMethod::ENO_Roe:
+         method = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodEnoRoe( nx, ny, bufferWidth, dx, dy, boundary, params.gamma, params.eno_order ) };
+         break;
+      case IntegrationMethod::ENO_LF:
+         method = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodEnoLF( nx, ny, bufferWidth, dx, dy, boundary, params.gamma, enoSystem, EnoLFSplitting::Characteristic, 0.0, EnoLFReconstruction::ENO, params.eno_order, lfViscosity ) };
+         break;
+      case IntegrationMethod::ENO_LF_Hybrid:
+         method = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodEnoLF( nx, ny, bufferWidth, dx, dy, boundary, params.gamma, enoSystem, EnoLFSplitting::Hybrid, params.hybrid_threshold, EnoLFReconstruction::ENO, params.eno_order, lfViscosity ) };
+         break;
+      case IntegrationMethod::ENO_LF_Componentwise:
+         method = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodEnoLF( nx, ny, bufferWidth, dx, dy, boundary, params.gamma, enoSystem, EnoLFSplitting::Componentwise, 0.0, EnoLFReconstruction::ENO, params.eno_order, lfViscosity ) };
+         break;
+      case IntegrationMethod::WENO5_LF:
+         method = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodEnoLF( nx, ny, bufferWidth, dx, dy, boundary, params.gamma, enoSystem, EnoLFSplitting::Characteristic, 0.0, EnoLFReconstruction::WENO5, 5, lfViscosity ) };
+         break;
+      case IntegrationMethod::HLLD:
+         method = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodHLLD( nx, ny, bufferWidth, dx, dy, boundary, params.gamma ) };
+         break;
+      }
+      return method;
+   };
+   // On stretched grids, dx and dy of the methods are the smallest cell widths
+   auto dxMin = params.dx;
+   auto dyMin = params.dy;
+   if( params.stretched ){
+      dxMin = *std::min_element( params.dx_cell+NXFIRST, params.dx_cell+NXLAST );
+      dyMin = *std::min_element( params.dy_cell+NYFIRST, params.dy_cell+NYLAST );
+   }
+   auto method_ptr = createMethod( params.nx, activeParams.ny, dxMin, dyMin );
    auto stepper = std::unique_ptr<TimeIntegrationMethod>{};
-   switch( params.scheme ){
-   case IntegrationMethod::Undefined:
+   if( params.stretched ){
+      method_ptr->setGridSpacing( activeParams.dx_cell, activeParams.dy_cell );
+   }
+   method_ptr->initializeDirichletBoundaries( activeU );
+   // skipping uniform regions and caching eigensystems do not change the result, so they are
+   // used wherever supported
+   method_ptr->setSkipUniform( params.skip_uniform );
+   method_ptr->setEigensystemCache( params.cache_eigensystems );
+   method_ptr->setMirrorBottom( mirror );
+   if( !method_ptr->setOneDimensional( oneDimensional ) ){
       criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
-                   + "main: Unknown space integration method." );
-   case IntegrationMethod::CentralFD:
-      method_ptr = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodCentralFD2( params.nx, params.ny, bufferWidth, params.dx, params.dy, boundary, params.gamma ) };
-      break;
-   case IntegrationMethod::ENO_Roe:
-      method_ptr = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodEnoRoe( params.nx, params.ny, bufferWidth, params.dx, params.dy, boundary, params.gamma ) };
-      break;
-   case IntegrationMethod::ENO_LF:
-      method_ptr = std::unique_ptr<SpatialIntegrationMethod>{ new SpatialMethodEnoLF( params.nx, params.ny, bufferWidth, params.dx, params.dy, boundary, params.gamma ) };
-      break;
+                   + "main: One-dimensional integration requires space method eno-roe, hlld or an eno-lf or weno5-lf method." );
+   }
+   if( !method_ptr->setAlfvenSpeedLimit( params.alfven_limit ) ){
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "main: Alfven speed limit requires space method eno-roe or an eno-lf or weno5-lf method." );
+   }
+
+   // Local time stepping needs the numerical fluxes between bands, and bands at least as high
+   // as the buffer, so that the buffer of a band only reaches into its neighbours
+   if( params.local_bands > 1 ){
+      if( params.time_stepping != TimeStepMethod::RungeKutta3_TVD || !enoLF ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "main: Local time stepping requires time method rk3 and an eno-lf or weno5-lf space method." );
+      }
+      if( params.dt_control != TimeStepControl::Continuous ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "main: Local time stepping requires dt control = continuous." );
+      }
+      if( oneDimensional ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "main: Local time stepping requires two-dimensional integration." );
+      }
+      if( size_t(params.ny) < size_t(params.local_bands)*bufferWidth ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "main: Too many local time stepping bands, each band needs at least "
+                      + std::to_string( bufferWidth ) + " rows." );
+      }
+   }
+
+   // The refined patch covers rows of the whole grid width, so that it only has coarse-fine
+   // faces in y, where the numerical fluxes are corrected as between local time stepping bands
+   auto fineMethod_ptr = std::unique_ptr<SpatialIntegrationMethod>{};
+   if( params.refine ){
+      if( params.time_stepping != TimeStepMethod::RungeKutta3_TVD || !enoLF ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "main: Refinement requires time method rk3 and an eno-lf or weno5-lf space method." );
+      }
+      if( oneDimensional || mirror || params.local_bands > 1 || params.stretched
+          || params.time_mode == TimeStepMode::ErrorControlled ){
+         criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                      + "main: Refinement cannot be combined with one-dimensional integration, mirror symmetry,\n"
+                      + "local time stepping, error-controlled time stepping or a stretched grid." );
+      }
+      fineMethod_ptr = createMethod( 2*params.nx, 2*params.ny, 0.5*params.dx, 0.5*params.dy );
+      fineMethod_ptr->setSkipUniform( params.skip_uniform );
+      fineMethod_ptr->setEigensystemCache( params.cache_eigensystems );
+      fineMethod_ptr->setAlfvenSpeedLimit( params.alfven_limit );
    }
-   method_ptr->initializeDirichletBoundaries( data.U );
 
    // Time integrator
    switch( params.time_stepping ){
@@ -143,12 +283,53 @@ int main
       criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
                    + "main: Unknown time stepping method." );
    case TimeStepMethod::Euler:
-      stepper = std::unique_ptr<TimeIntegrationMethod>{ new TimeIntegrationEuler( params.nx, params.ny, bufferWidth, params.dt_min, params.dt_max, params.cfl_number, std::move(method_ptr) ) };
+      stepper = std::unique_ptr<TimeIntegrationMethod>{ new TimeIntegrationEuler( params.nx, activeParams.ny, bufferWidth, params.dt_min, params.dt_max, params.cfl_number, std::move(method_ptr) ) };
       break;
    case TimeStepMethod::RungeKutta3_TVD:
-      stepper = std::unique_ptr<TimeIntegrationMethod>{ new TimeIntegrationRK3( params.nx, params.ny, bufferWidth, params.dt_min, params.dt_max, params.cfl_number, std::move(method_ptr) ) };
+      if( params.local_bands > 1 ){
+         stepper = std::unique_ptr<TimeIntegrationMethod>{ new TimeIntegrationRK3Local( params.nx, activeParams.ny, bufferWidth, params.dt_min, params.dt_max, params.cfl_number, std::move(method_ptr), activeParams.dy_cell, params.local_bands, params.local_levels, boundary.top == BoundaryCondition::Periodic && boundary.bottom == BoundaryCondition::Periodic && !mirror ) };
+         break;
+      }
+      if( params.refine ){
+         stepper = std::unique_ptr<TimeIntegrationMethod>{ new TimeIntegrationRK3Refined( params.nx, params.ny, bufferWidth, params.dt_min, params.dt_max, params.cfl_number, std::move(method_ptr), std::move(fineMethod_ptr), params.dy, params.gamma, params.refine_threshold, params.refine_margin, params.refine_steps ) };
+         break;
+      }
+      stepper = std::unique_ptr<TimeIntegrationMethod>{ new TimeIntegrationRK3( params.nx, activeParams.ny, bufferWidth, params.dt_min, params.dt_max, params.cfl_number, std::move(method_ptr) ) };
       break;
+   case TimeStepMethod::RungeKutta3_TVD_LowStorage:
+      stepper = std::unique_ptr<TimeIntegrationMethod>{ new TimeIntegrationRK3LowStorage( params.nx, activeParams.ny, bufferWidth, params.dt_min, params.dt_max, params.cfl_number, std::move(method_ptr) ) };
+      break;
+   case TimeStepMethod::SSPRK43:
+      stepper = std::unique_ptr<TimeIntegrationMethod>{ new TimeIntegrationSSPRK43( params.nx, activeParams.ny, bufferWidth, params.dt_min, params.dt_max, params.cfl_number, std::move(method_ptr) ) };
+      break;
+   case TimeStepMethod::RungeKutta3_IMEX:
+      stepper = std::unique_ptr<TimeIntegrationMethod>{ new TimeIntegrationRK3Imex( params.nx, activeParams.ny, bufferWidth, params.dt_min, params.dt_max, params.cfl_number, std::move(method_ptr), boundary, mirror, params.imex_cfl_factor, params.imex_tolerance, params.imex_iterations ) };
+      break;
+   }
+
+   stepper->setTimeStepControl( params.dt_control );
+   if( params.time_mode == TimeStepMode::ErrorControlled
+       && !stepper->setErrorControl( params.error_tolerance, params.error_tolerance_abs ) ){
+      criticalError( ReturnStatus::ErrorWrongParameter, std::string{}
+                   + "main: Time stepping method " + toString( params.time_stepping )
+                   + " has no error estimate, error-controlled time stepping requires rk3 or rk3-imex." );
+   }
+
+   // Scheduler for tiled grid loops
+   auto scheduler = std::make_shared<TileScheduler>( params.threads, params.tile_size );
+   if( scheduler->getThreadCount() < size_t(params.threads) ){
+      ERROUT << "WARNING: main: Compiled without thread support, running on "
+             << scheduler->getThreadCount() << " thread instead of " << params.threads << ".\n";
    }
+   if( params.pin_threads && !scheduler->pinThreads( params.cpu_list ) ){
+      ERROUT << "WARNING: main: Unable to pin all threads to CPUs.\n";
+   }
+   // place the state and scratch arrays in memory local to the threads that process them
+   scheduler->distribute( data.U, PRB_DIM, NX, NY );
+   freeMatricesView( activeU );
+   activeU = createMatricesView( data.U, PRB_DIM, NX, mirror ? params.ny/2 : 0 );
+   stepper->setScheduler( scheduler );
+   scheduler->resetStatistics();
 
    // Frequency of reporting progress to stdout
    int step_progress = 0;
@@ -164,6 +345,9 @@ int main
    double output_time_file   = output_grid.skip_t;
    double output_time_screen = params.t_max/100.0;
    double output_time_non_grid = output_non_grid.skip_t;
+   // points with Alfven speed above the limit: total and largest count per step
+   double limited_points_sum = 0.0;
+   int    limited_points_max = 0;
 
    /* main loop clock */
    clmain = nchrono::steady_clock::now();
@@ -183,11 +367,20 @@ int main
             retval = stepEuler( data.U, data.dt, params );
             break;
          case TimeStepMethod::RungeKutta3_TVD:
+         case TimeStepMethod::RungeKutta3_TVD_LowStorage:
             retval = stepRK3TVD( data.U, data.dt, params );
             break;
+         case TimeStepMethod::SSPRK43:
+            criticalError( ReturnStatus::ErrorNotImplemented, std::string{}
+                         + "main: Time stepping method ssprk43 not implemented in old style stepping." );
+            break;
+         case TimeStepMethod::RungeKutta3_IMEX:
+            criticalError( ReturnStatus::ErrorNotImplemented, std::string{}
+                         + "main: Time stepping method rk3-imex not implemented in old style stepping." );
+            break;
          }
       #else
-         retval = stepper->step( data.U, data.cx, data.cy, data.LUx, data.LUy, data.borderFlux, data.dt );
+         retval = stepper->step( activeU, activeCx, activeCy, activeLUx, activeLUy, data.borderFlux, data.dt );
       #endif // OLD_STYLE
 
       // Process the return value
@@ -204,8 +397,18 @@ int main
          break;
       }
 
-      // correct div B
-      if( step%params.divb_skip_steps == 0 ){
+      // count points limited by the Boris correction
+      if( params.alfven_limit > 0.0 ){
+         auto limited_points = countAlfvenLimitedPoints( activeParams, activeU ) * ( params.ny/activeParams.ny );
+         limited_points_sum += limited_points;
+         limited_points_max = std::max( limited_points_max, limited_points );
+         if( params.log_params.alfven_limit ){
+            OUT << "alfven limiter, step #" << step << ": " << limited_points << " points above the limit.\n";
+         }
+      }
+
+      // correct div B; in one dimension, Bx (and with it div B) does not change
+      if( !oneDimensional && step%params.divb_skip_steps == 0 ){
          switch( params.divb_method ){
          case DivBCorrectionMethod::Undefined:
             break;
@@ -215,7 +418,7 @@ int main
             }
             double divbsum, divbmax;
             for( int i = 0; i < params.divb_sor_steps; i++ ){
-               divBCalculation( data.U, params, divbmax, divbsum );
+               divBCalculation( activeU, activeParams, divbmax, divbsum, scheduler.get() );
                if( params.log_params.divb_step ){
                   OUT << "divb corrector, step #" << step << ", loop #" << i << ": divbmax = " << divbmax << "\n";
                }
@@ -225,13 +428,13 @@ int main
                   }
                   break;
                }
-               retval = divBCorrectionSOR( data.U, params );
+               retval = divBCorrectionSOR( activeU, activeParams );
                if( retval.status == ReturnStatus::ErrorNotConverged ){
                   ERROUT << "WARNING: Div B corrector, r failed to converge.\n";
                   break;
                }
             }
-            divBCalculation( data.U, params, divbmax, divbsum );
+            divBCalculation( activeU, activeParams, divbmax, divbsum, scheduler.get() );
             if( divbmax > params.divb_sor_max ){
                ERROUT << "WARNING: Div B corrector failed to converge: divbmax = " << divbmax << "\n"
                       << "         Simulation resumed, but B may be erroneous." << LF;
@@ -259,6 +462,7 @@ int main
          output_to_screen = step%step_progress == 0;
          break;
       case TimeStepMode::Variable:
+      case TimeStepMode::ErrorControlled:
          done = data.t_current >= params.t_max;
          output_to_screen = data.t_current >= output_time_screen;
          while( output_to_screen && ( output_time_screen <= data.t_current ) )
@@ -297,12 +501,28 @@ int main
       }
 
       // output data to file
+      if( oneDimensional && ( output_to_file || output_to_non_grid ) )
+         copyFirstRow( params, PRB_DIM, data.U );
+      if( mirror && ( output_to_file || output_to_non_grid ) )
+         mirrorUpperHalf( params, PRB_DIM, data.U, true );
       if( output_to_file || output_to_non_grid )
          toNaturalData( params, data );
       if( output_to_file ){
          outputGridData( output_grid, params, data, step, record_index++ );
          if( params.log_params.characteristics && step > 0
-             && ( params.scheme == IntegrationMethod::ENO_Roe || params.scheme == IntegrationMethod::ENO_LF ) ){
+             && ( params.scheme == IntegrationMethod::ENO_Roe || enoLF ) ){
+            if( oneDimensional ){
+               copyFirstRow( params, PRB_DIM, data.cx );
+               copyFirstRow( params, PRB_DIM, data.LUx );
+               copyFirstRow( params, PRB_DIM, data.cy );
+               copyFirstRow( params, PRB_DIM, data.LUy );
+            }
+            if( mirror ){
+               mirrorUpperHalf( params, PRB_DIM, data.cx, false );
+               mirrorUpperHalf( params, PRB_DIM, data.LUx, false );
+               mirrorUpperHalf( params, PRB_DIM, data.cy, false );
+               mirrorUpperHalf( params, PRB_DIM, data.LUy, false );
+            }
             outputCharacteristicsBinary( output_characteristics, params, data.cx, data.cy, data.LUx, data.LUy, data.t_current, step, record_index );
          }
       }
@@ -324,6 +544,7 @@ int main
                 << (100.0*step/params.steps) << "%) done." << LF;
             break;
          case TimeStepMode::Variable:
+         case TimeStepMode::ErrorControlled:
             OUT << "@ t = " << duration.count() << " sec : "
                 << step << " steps done, "
                 << data.t_current << " / " << params.t_max << " simulated time ("
@@ -333,7 +554,7 @@ int main
       }
 
       // stop if NaN encountered
-      if( std::isnan( data.U[0][NXFIRST][NYFIRST] ) ){
+      if( std::isnan( activeU[0][NXFIRST][NYFIRST] ) ){
          ERROUT << "WARNING: NaN detected. Stopping simulation at step " << step
                 << ", t = " << data.t_current << ", with "
                 << record_index-1 << " grids recorded." << LF;
@@ -354,10 +575,22 @@ int main
    OUT << "@ t = " << duration.count() << " sec : Simulation finished.\n"
        << " - Grids recorded     : " << record_index-1 << "\n"
        << " - Successful steps   : " << step-1 << "\n"
-       << " - Simulated time     : " << data.t_current << "\n";
+       << " - Rejected steps     : " << stepper->getRejectedSteps() << "\n";
+   if( params.time_mode == TimeStepMode::ErrorControlled ){
+      OUT << "   (error control)   : " << stepper->getErrorRejectedSteps() << "\n";
+   }
+   stepper->printStatistics( OUT );
+   if( params.alfven_limit > 0.0 && step > 1 ){
+      OUT << " - Alfven limited     : " << limited_points_sum/(step-1) << " points per step on average, "
+          << limited_points_max << " at most\n";
+   }
+   OUT << " - Simulated time     : " << data.t_current << "\n";
    duration = nchrono::steady_clock::now() - clmain;
    OUT << " - Main loop duration : " << duration.count() << " seconds\n"
        << " - Time step average  : " << duration.count()/(step-1) << " seconds.\n";
+   if( scheduler->getThreadCount() > 1 ){
+      scheduler->printStatistics( OUT );
+   }
 
    return 0;
 }
@@ -394,6 +627,38 @@ void criticalError
    exit( errcode );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t requiredBufferWidth
+   ( const t_params &params
+){
+   auto width = size_t{0};
+
+   switch( params.scheme ){
+   case IntegrationMethod::Undefined:
+      break;
+   case IntegrationMethod::CentralFD:
+      width = SpatialMethodCentralFD2::requiredBufferWidth();
+      break;
+   case IntegrationMethod::ENO_Roe:
+      width = SpatialMethodEnoRoe::requiredBufferWidth( params.eno_order );
+      break;
+   case IntegrationMethod::ENO_LF:
+   case IntegrationMethod::ENO_LF_Hybrid:
+   case IntegrationMethod::ENO_LF_Componentwise:
+      width = SpatialMethodEnoLF::requiredBufferWidth( EnoLFReconstruction::ENO, params.eno_order );
+      break;
+   case IntegrationMethod::WENO5_LF:
+      width = SpatialMethodEnoLF::requiredBufferWidth( EnoLFReconstruction::WENO5 );
+      break;
+   case IntegrationMethod::HLLD:
+      width = SpatialMethodHLLD::requiredBufferWidth();
+      break;
+   }
+
+   // the div B correction and the old style stepping use two points on each side
+   return std::max( width, size_t{2} );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void defaultExceptionHandler
    (
@@ -64,14 +64,20 @@
 #define PRB_DIM 8
 #define VEL_DIM 3
 
+// Sign of variable k of U under the reflection y -> -y of a mirror symmetric state:
+// my, bx and bz are odd (the field of a current sheet reverses across it), the rest even
+#define MIRROR_PARITY_Y(k) ( ((k)==2 || (k)==4 || (k)==6) ? -1.0 : 1.0 )
+
 // Array sizes
-//  - data is in [2..n+1] with [0], [1], [n+2] and [n+3] as buffers
-#define NX      (params.nx+4)
-#define NY      (params.ny+4)
-#define NXFIRST (2)
-#define NYFIRST (2)
-#define NXLAST  (params.nx+2)
-#define NYLAST  (params.ny+2)
+//  - data is in [b..n+b-1] with [0..b-1] and [n+b..n+2b-1] as buffers, for the buffer width
+//    b = params.buffer_width that the stencils of the space method need (see
+//    requiredBufferWidth), at least 2
+#define NX      (params.nx+2*NXFIRST)
+#define NY      (params.ny+2*NYFIRST)
+#define NXFIRST (params.buffer_width)
+#define NYFIRST (params.buffer_width)
+#define NXLAST  (params.nx+NXFIRST)
+#define NYLAST  (params.ny+NYFIRST)
 
 #define EPS            (1e-20)
 #define EPS_EQUAL(a,b) (std::abs((a)-(b))<EPS)
@@ -116,6 +122,7 @@ typedef struct {
    bool r_end;
    bool divb_step;
    bool characteristics;
+   bool alfven_limit;
 } t_log_params;
 
 typedef struct {
@@ -135,18 +142,40 @@ typedef struct {
    // Grid parameters
    int    nx;
    int    ny;
-   double dx;
+   int    buffer_width; // ghost points on each side of the arrays (NXFIRST, NYFIRST)
+   double dx;           // Lx/nx, the spacing of a uniform grid
    double dy;
    double start_x;
    double start_y;
+   bool     stretched;  // non-uniform spacing; the arrays below cover the ghost points too
+   t_vector dx_cell;    //    width of the cell around each point
+   t_vector dy_cell;
+   t_vector dx_central; //    distance between the neighbours of each point
+   t_vector dy_central;
+   t_vector x_point;    //    coordinates of the points
+   t_vector y_point;
+   int    dimensions;   // 1 (uniform in y), 2, or 0 to detect from the initial state
+   Symmetry symmetry_y; // mirror: only the upper half of the grid is integrated
+   bool   refine;           // refined patch around steep gradients
+   double refine_threshold; //    relative change between points that is refined
+   int    refine_margin;    //    rows added on both sides of the refined rows
+   int    refine_steps;     //    steps between moves of the patch
 
    // Time parameters
    TimeStepMode time_mode;
+   TimeStepControl dt_control;
    int    steps;
    double cfl_number;
    double dt_min;
    double dt_max;
    double t_max;
+   double error_tolerance;
+   double error_tolerance_abs;
+   int    local_bands;
+   int    local_levels;
+   double imex_cfl_factor;  // semi-implicit time stepping: dt relative to the explicit one,
+   double imex_tolerance;   //    relative residual of the conjugate gradients,
+   int    imex_iterations;  //    and their iteration limit
 
    // Simulation parameters
    const int b_count  = 4;
@@ -158,9 +187,16 @@ typedef struct {
    t_vectors         boundary_dirichlet_U[4];
    TimeStepMethod    time_stepping;
    IntegrationMethod scheme;
+   bool              reduced_system;
+   bool              skip_uniform;
+   bool              cache_eigensystems;
+   double            hybrid_threshold;
+   bool              local_viscosity;
+   int               eno_order;
 
    // Physical parameters
    double gamma;
+   double alfven_limit;
 
    // Div B corrector parameters
    DivBCorrectionMethod divb_method;
@@ -174,6 +210,12 @@ typedef struct {
 
    bool break_on_neg_pressure;
 
+   // Parallelization parameters
+   int    threads;
+   int    tile_size;
+   bool   pin_threads;
+   std::vector<int> cpu_list;
+
    // logging parameters
    t_log_params log_params;
 } t_params;
@@ -209,6 +251,11 @@ void criticalError
    ( ReturnStatus       error
    , const std::string  message );
 
+// Space method - buffer width (ghost points on each side of the arrays) that the stencils of
+// the space method of params need
+size_t requiredBufferWidth
+   ( const t_params &params );
+
 // File access - open & close
 void openFile
    ( t_output &output );
@@ -276,6 +323,45 @@ void toConservationData
    ( const t_params &params
    , t_data &data );
 
+// Reduced system - true if w = Bz = 0 in the whole interior
+bool isPlanarState
+   ( const t_params &params
+   , t_matrices U );
+
+// Hydrodynamic system - true if B = 0 in the whole interior
+bool isHydroState
+   ( const t_params &params
+   , t_matrices U );
+
+// One-dimensional problems - true if all interior rows are equal
+bool isUniformInY
+   ( const t_params &params
+   , t_matrices U );
+
+// Mirror symmetry - true if the state is mirror symmetric about the horizontal midplane
+bool isMirrorSymmetricInY
+   ( const t_params &params
+   , t_matrices U );
+
+// Mirror symmetry - fill the lower half of the n matrices M from the upper half, with the
+// parities of the variables of U if parity is true, unchanged otherwise
+void mirrorUpperHalf
+   ( const t_params &params
+   , int n
+   , t_matrices M
+   , bool parity );
+
+// One-dimensional problems - copy the first interior row of the n matrices M to all rows
+void copyFirstRow
+   ( const t_params &params
+   , int n
+   , t_matrices M );
+
+// Boris correction - number of interior points with Alfven speed above the limit
+int countAlfvenLimitedPoints
+   ( const t_params &params
+   , t_matrices U );
+
 // Time stepper - Third order optimal TVD Runge-Kutta time stepping method
 t_status stepRK3TVD
    ( t_matrices  U
@@ -307,12 +393,14 @@ t_status divBCorrectionSOR
    ( t_matrices U
    , const t_params &params );
 
-// Div B calculation - maximum and total
+// Div B calculation - maximum and total; rows are tiled if a scheduler is given
+class TileScheduler;
 void divBCalculation
    ( t_matrices U
    , const t_params &params
    , double &maxdivb
-   , double &totdivb );
+   , double &totdivb
+   , TileScheduler *scheduler = nullptr );
 
 #ifdef USE_THREAD_EXCEPTIONS
 // Class for exception handling that can be used in OpenMP parallelized code
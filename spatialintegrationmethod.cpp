@@ -18,7 +18,17 @@ SpatialIntegrationMethod::SpatialIntegrationMethod
    , nxFirst{ 0 +bufferWidth   }, nyFirst{ 0 +bufferWidth   }
    , nxLast { nx+bufferWidth   }, nyLast { ny+bufferWidth   }
    , nxTotal{ nx+bufferWidth*2 }, nyTotal{ ny+bufferWidth*2 }
+   , rowFirst{ nyFirst }, rowLast{ nyLast }
 {
+   scheduler = std::make_shared<TileScheduler>( 1, nxTotal );
+
+   dxInv.assign( nxTotal, 1.0/dx );
+   dyInv.assign( nyTotal, 1.0/dy );
+   dxCentralInv.assign( nxTotal, 1.0/(2.0*dx) );
+   dyCentralInv.assign( nyTotal, 1.0/(2.0*dy) );
+   waveScaleX.assign( nxTotal, 1.0 );
+   waveScaleY.assign( nyTotal, 1.0 );
+
    requireBoundaryInitialization = boundary.left   == BoundaryCondition::Dirichlet
                                 || boundary.right  == BoundaryCondition::Dirichlet
                                 || boundary.top    == BoundaryCondition::Dirichlet
@@ -35,7 +45,30 @@ SpatialIntegrationMethod::~SpatialIntegrationMethod
    if( dirichletBoundaryBottom   ) freeVectors( dirichletBoundaryBottom  );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialIntegrationMethod::setGridSpacing
+   ( const t_vector dxCell
+   , const t_vector dyCell
+){
+   stretched = true;
+   // the ghost points at the ends only have one neighbour; their cells mirror the interior
+   auto central = []( const t_vector width, size_t i, size_t n ){
+      if( i == 0 || i+1 == n ) return 2.0*width[i];
+      return 0.5*( width[i-1] + width[i+1] ) + width[i];
+   };
+   for( auto i = size_t{0}; i < nxTotal; i++ ){
+      dxInv[i]        = 1.0/dxCell[i];
+      dxCentralInv[i] = 1.0/central( dxCell, i, nxTotal );
+      waveScaleX[i]   = dx/dxCell[i];
+   }
+   for( auto j = size_t{0}; j < nyTotal; j++ ){
+      dyInv[j]        = 1.0/dyCell[j];
+      dyCentralInv[j] = 1.0/central( dyCell, j, nyTotal );
+      waveScaleY[j]   = dy/dyCell[j];
+   }
+}
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void SpatialIntegrationMethod::initializeDirichletBoundaries
    ( t_matrices U
 ){
@@ -58,6 +91,104 @@ void SpatialIntegrationMethod::initializeDirichletBoundaries
    requireBoundaryInitialization = false;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialIntegrationMethod::distributeMemory
+   (
+){
+   // no scratch arrays
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialIntegrationMethod::setScheduler
+   ( std::shared_ptr<TileScheduler> scheduler
+){
+   this->scheduler = scheduler;
+   distributeMemory();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialIntegrationMethod::setActiveRows
+   ( size_t first
+   , size_t last
+){
+   rowFirst = std::max( first, nyFirst );
+   rowLast  = std::min( last,  nyLast  );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialIntegrationMethod::getFluxY
+   ( size_t     /*j*/
+   , t_vectors  /*flux*/
+){
+   return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialIntegrationMethod::setAlfvenSpeedLimit
+   ( double cLimit
+){
+   return cLimit <= 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialIntegrationMethod::setSkipUniform
+   ( bool skip
+){
+   return !skip;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialIntegrationMethod::setEigensystemCache
+   ( bool cache
+){
+   return !cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialIntegrationMethod::printStatistics
+   ( std::ostream &/*out*/
+) const {
+   // nothing to report
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialIntegrationMethod::setMirrorBottom
+   ( bool mirror
+){
+   mirrorBottom = mirror;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialIntegrationMethod::setOneDimensional
+   ( bool oneDimensional
+){
+   return !oneDimensional;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialIntegrationMethod::getRowDtIdeal
+   ( const t_matrices     /*U*/
+   , std::vector<double> &/*dtIdeal*/
+){
+   return { true, ReturnStatus::ErrorNotImplemented
+          , "row-wise time steps not implemented\n! SpatialIntegrationMethod::getRowDtIdeal" };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialIntegrationMethod::integrateStage
+   ( const t_stageUpdate  &stage
+   , t_matrices            U
+   , t_matrices            UL
+   , borderVectors         borderFlux
+   , double               &dtIdeal
+){
+   scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+      applyStageUpdate( stage, U, iFirst, iLast );
+   } );
+
+   return integrate( U, UL, borderFlux, dtIdeal );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 size_t SpatialIntegrationMethod::requiredBufferWidth
    (
@@ -88,7 +219,81 @@ t_status SpatialIntegrationMethod::applyBoundaryConditions
    if( requireBoundaryInitialization ){
       return { true, ReturnStatus::ErrorWrongParameter, "SpatialIntegrationMethod::applyBoundaryConditions: boundary not initialized." };
    }
-   // left boundary
+
+   auto status = applyBoundaryLeft( U );
+   if( status.isError ) return status;
+   status = applyBoundaryRight( U );
+   if( status.isError ) return status;
+   status = applyBoundaryBottom( U );
+   if( status.isError ) return status;
+   status = applyBoundaryTop( U );
+   if( status.isError ) return status;
+
+   return { false, ReturnStatus::OK, "" };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<TileGraph::t_node> SpatialIntegrationMethod::addBoundaryTasks
+   ( TileGraph                             &graph
+   , t_matrices                             U
+   , TileResults                           &results
+   , const std::vector<TileGraph::t_node>  &dependencies
+){
+   if( requireBoundaryInitialization ){
+      results.setError( 0, 0, { true, ReturnStatus::ErrorWrongParameter, "SpatialIntegrationMethod::applyBoundaryConditions: boundary not initialized." } );
+      return {};
+   }
+
+   // each edge only writes its own ghost cells, and only reads the interior and its own
+   // ghost cells, so the edges can be processed in any order; errors are ordered as in
+   // applyBoundaryConditions
+   typedef t_status (SpatialIntegrationMethod::*t_edgeFunction)( t_matrices U );
+   const t_edgeFunction edges[4] = { &SpatialIntegrationMethod::applyBoundaryLeft
+                                   , &SpatialIntegrationMethod::applyBoundaryRight
+                                   , &SpatialIntegrationMethod::applyBoundaryBottom
+                                   , &SpatialIntegrationMethod::applyBoundaryTop };
+
+   auto nodes = std::vector<TileGraph::t_node>{};
+   for( auto e = size_t{0}; e < 4; e++ ){
+      auto edge = edges[e];
+      nodes.push_back( graph.addTask( 0, 1, [this, edge, e, U, &results]( size_t, size_t, size_t thread ){
+         auto status = (this->*edge)( U );
+         if( status.isError ){
+            results.setError( thread, e, status );
+         }
+      }, dependencies ) );
+   }
+
+   return nodes;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialIntegrationMethod::applyStageUpdate
+   ( const t_stageUpdate  &stage
+   , t_matrices            U
+   , size_t                iFirst
+   , size_t                iLast
+){
+   iFirst = std::max( iFirst, nxFirst );
+   iLast  = std::min( iLast,  nxLast  );
+
+   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+      for( auto i = iFirst; i < iLast; i++ ){
+         if( stage.U1 ){
+            for( auto j = rowFirst; j < rowLast; j++ )
+               U[k][i][j] = stage.a0*stage.U0[k][i][j] + stage.a1*stage.U1[k][i][j] + stage.c*stage.L[k][i][j];
+         } else {
+            for( auto j = rowFirst; j < rowLast; j++ )
+               U[k][i][j] = stage.a0*stage.U0[k][i][j] + stage.c*stage.L[k][i][j];
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialIntegrationMethod::applyBoundaryLeft
+   ( t_matrices U
+){
    switch( boundary.left ){
    case BoundaryCondition::Undefined:
       return { true, ReturnStatus::ErrorWrongParameter, "Unknown left boundary condition." };
@@ -124,6 +329,7 @@ t_status SpatialIntegrationMethod::applyBoundaryConditions
          double ratio_xy = dx/dy;
          for( auto i = nxFirst; i > 0; i-- ){
             for( auto j = nyFirst+1; j < nyLast-1; j++ ){
+               if( stretched ) ratio_xy = dyCentralInv[j]/dxCentralInv[i];
                U[4][i-1][j] = U[4][i+1][j] - ratio_xy*( U[5][i][j-1] - U[5][i][j+1] );
             }
          }
@@ -140,7 +346,13 @@ t_status SpatialIntegrationMethod::applyBoundaryConditions
       break;
    }
 
-   // right boundary
+   return { false, ReturnStatus::OK, "" };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialIntegrationMethod::applyBoundaryRight
+   ( t_matrices U
+){
    switch( boundary.right ){
    case BoundaryCondition::Undefined:
       return { true, ReturnStatus::ErrorWrongParameter, "Unknown right boundary condition." };
@@ -176,6 +388,7 @@ t_status SpatialIntegrationMethod::applyBoundaryConditions
          double ratio_xy = dx/dy;
          for( auto i = nxLast-1; i < nxTotal-1; i++ ){
             for( auto j = nyFirst+1; j < nyLast-1; j++ ){
+               if( stretched ) ratio_xy = dyCentralInv[j]/dxCentralInv[i];
                U[4][i+1][j] = U[4][i-1][j] - ratio_xy*( U[5][i][j+1] - U[5][i][j-1] );
             }
          }
@@ -192,7 +405,22 @@ t_status SpatialIntegrationMethod::applyBoundaryConditions
       break;
    }
 
-   // bottom boundary
+   return { false, ReturnStatus::OK, "" };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialIntegrationMethod::applyBoundaryBottom
+   ( t_matrices U
+){
+   if( oneDimensional ){
+      applyUniformRows( U, true );
+      return { false, ReturnStatus::OK, "" };
+   }
+   if( mirrorBottom ){
+      applyMirrorRows( U );
+      return { false, ReturnStatus::OK, "" };
+   }
+
    switch( boundary.bottom ){
    case BoundaryCondition::Undefined:
       return { true, ReturnStatus::ErrorWrongParameter, "Unknown bottom boundary condition." };
@@ -228,6 +456,7 @@ t_status SpatialIntegrationMethod::applyBoundaryConditions
          double ratio_yx = dy/dx;
          for( auto i = nxFirst+1; i < nxLast-1; i++ ){
             for( auto j = nyFirst; j > 0; j-- ){
+               if( stretched ) ratio_yx = dxCentralInv[i]/dyCentralInv[j];
                U[5][i][j-1] = U[5][i][j+1] - ratio_yx*( U[4][i-1][j] - U[4][i+1][j] );
             }
          }
@@ -244,7 +473,18 @@ t_status SpatialIntegrationMethod::applyBoundaryConditions
       break;
    }
 
-   // top boundary
+   return { false, ReturnStatus::OK, "" };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialIntegrationMethod::applyBoundaryTop
+   ( t_matrices U
+){
+   if( oneDimensional ){
+      applyUniformRows( U, false );
+      return { false, ReturnStatus::OK, "" };
+   }
+
    switch( boundary.top ){
    case BoundaryCondition::Undefined:
       return { true, ReturnStatus::ErrorWrongParameter, "Unknown top boundary condition." };
@@ -280,6 +520,7 @@ t_status SpatialIntegrationMethod::applyBoundaryConditions
          double ratio_yx = dy/dx;
          for( auto i = nxFirst+1; i < nxLast-1; i++ ){
             for( auto j = nyLast-1; j < nyTotal-1; j++ ){
+               if( stretched ) ratio_yx = dxCentralInv[i]/dyCentralInv[j];
                U[5][i][j+1] = U[5][i][j-1] - ratio_yx*( U[4][i+1][j] - U[4][i-1][j] );
             }
          }
@@ -298,3 +539,35 @@ t_status SpatialIntegrationMethod::applyBoundaryConditions
 
    return { false, ReturnStatus::OK, "" };
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialIntegrationMethod::applyUniformRows
+   ( t_matrices U
+   , bool       bottom
+){
+   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+      for( auto i = nxFirst; i < nxLast; i++ ){
+         for( auto j = size_t{1}; j <= bufferWidth; j++ ){
+            if( bottom ){
+               U[k][i][nyFirst-j] = U[k][i][nyFirst];
+            } else {
+               U[k][i][nyLast-1+j] = U[k][i][nyLast-1];
+            }
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialIntegrationMethod::applyMirrorRows
+   ( t_matrices U
+){
+   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+      auto sign = MIRROR_PARITY_Y(k);
+      for( auto i = nxFirst; i < nxLast; i++ ){
+         for( auto j = size_t{1}; j <= bufferWidth; j++ ){
+            U[k][i][nyFirst-j] = sign*U[k][i][nyFirst+j-1];
+         }
+      }
+   }
+}
@@ -2,6 +2,19 @@
 #define SPATIALINTEGRATIONMETHOD_HPP
 
 #include "mhd2d.hpp"
+#include "tilescheduler.hpp"
+
+// Runge-Kutta stage combination U = a0*U0 + a1*U1 + c*L over the grid interior,
+// where c includes the time step; U1 may be nullptr, or the integrated U itself (the update
+// is pointwise)
+typedef struct {
+   t_matrices U0;
+   double     a0;
+   t_matrices U1;
+   double     a1;
+   t_matrices L;
+   double     c;
+} t_stageUpdate;
 
 class SpatialIntegrationMethod
 {
@@ -19,14 +32,84 @@ class SpatialIntegrationMethod
       void initializeDirichletBoundaries( t_matrices U
                                         );
 
+      // Run grid loops through the given scheduler (default: serial, single tile)
+      void setScheduler( std::shared_ptr<TileScheduler> scheduler
+                       );
+
       virtual t_status integrate( t_matrices       U
                                 , t_matrices       UL
                                 , borderVectors    borderFlux
                                 , double          &dtIdeal
                                 ) = 0;
 
+      // Compute the interior of U from stage, then integrate U; methods that override this
+      // do the stage update in the same sweep as their first pass over U. L may be UL
+      virtual t_status integrateStage( const t_stageUpdate  &stage
+                                     , t_matrices            U
+                                     , t_matrices            UL
+                                     , borderVectors         borderFlux
+                                     , double               &dtIdeal
+                                     );
+
       static size_t requiredBufferWidth();
 
+      // Restrict the following integrations to the interior rows [first,last); the rows within
+      // bufferWidth of them must hold valid values. UL is only computed for these rows, and a
+      // stage update only changes them. Methods may still integrate the whole grid
+      void setActiveRows( size_t first
+                        , size_t last
+                        );
+
+      // Numerical flux G through the faces between rows j and j+1 in the last integration, for
+      // the interior columns; returns false if the method does not provide it
+      virtual bool getFluxY( size_t     j
+                           , t_vectors  flux
+                           );
+
+      // Largest stable time step of each interior row of U, from the wave speeds of its points
+      virtual t_status getRowDtIdeal( const t_matrices     U
+                                    , std::vector<double> &dtIdeal
+                                    );
+
+      // Limit the Alfven speed to about cLimit with the (simplified) Boris correction; 0 turns the
+      // limit off. Returns false if the method does not support it
+      virtual bool setAlfvenSpeedLimit( double cLimit
+                                      );
+
+      // Copy the numerical fluxes between identical stencils (uniform regions) from the
+      // neighbouring face instead of computing them again; the result is the same to the bit.
+      // Returns false if the method does not support it
+      virtual bool setSkipUniform( bool skip
+                                 );
+
+      // Use the cell widths dxCell (nx plus ghost points) and dyCell (ny plus ghost points) of a
+      // stretched grid instead of the spacing dx, dy, which is then the smallest width. Methods
+      // difference the fluxes over the cell widths and limit the time step with the widths of
+      // the faces' cells; the reconstruction stays in index space
+      void setGridSpacing( const t_vector dxCell
+                         , const t_vector dyCell
+                         );
+
+      // Reuse the eigensystems of state pairs met at earlier faces (kept per thread and compared
+      // to the bit), instead of computing them again; the result is the same to the bit.
+      // Returns false if the method does not support it
+      virtual bool setEigensystemCache( bool cache
+                                      );
+
+      // Method-specific statistics, printed at the end of the simulation
+      virtual void printStatistics( std::ostream &out
+                                  ) const;
+
+      // Integrate the upper half of a problem mirror symmetric about the horizontal midplane:
+      // the bottom boundary is the mirror plane, which lies on the bottom faces of the first row
+      void setMirrorBottom( bool mirror
+                          );
+
+      // Integrate a problem uniform in y: only the fluxes F in x-direction are calculated (the
+      // grid then usually has a single row). Returns false if the method does not support it
+      virtual bool setOneDimensional( bool oneDimensional
+                                    );
+
       virtual bool getCharacteristicsX( t_matrices cx
                                       , t_matrices LUx
                                       );
@@ -52,6 +135,34 @@ class SpatialIntegrationMethod
       const size_t nxTotal;
       const size_t nyTotal;
 
+      std::shared_ptr<TileScheduler> scheduler;
+
+      // interior rows [rowFirst,rowLast) to integrate
+      size_t rowFirst;
+      size_t rowLast;
+
+      // problem uniform in y (set by methods that support it); the ghost rows then repeat the
+      // interior row instead of the top and bottom boundary conditions
+      bool oneDimensional = false;
+
+      // bottom boundary is a mirror plane (see setMirrorBottom)
+      bool mirrorBottom = false;
+
+      // grid spacing of each point (see setGridSpacing): inverse cell width and inverse distance
+      // between the neighbours, and the ratio of dx (dy) to the cell width, which scales the wave
+      // speeds for the time step; uniform grids have 1/dx, 1/(2dx) and 1
+      bool                 stretched = false;
+      std::vector<double>  dxInv;
+      std::vector<double>  dyInv;
+      std::vector<double>  dxCentralInv;
+      std::vector<double>  dyCentralInv;
+      std::vector<double>  waveScaleX;
+      std::vector<double>  waveScaleY;
+
+      // wave speed scale of the faces i+1/2 and j+1/2, from the narrower of their two cells
+      double faceScaleX( size_t i ) const { return std::max( waveScaleX[i], waveScaleX[i+1] ); }
+      double faceScaleY( size_t j ) const { return std::max( waveScaleY[j], waveScaleY[j+1] ); }
+
       bool requireBoundaryInitialization;
       t_vectors dirichletBoundaryLeft   = nullptr;
       t_vectors dirichletBoundaryRight  = nullptr;
@@ -61,6 +172,34 @@ class SpatialIntegrationMethod
       virtual t_status applyBoundaryConditions( t_matrices U
                                               );
 
+      // Move scratch arrays to memory first touched by the threads of the scheduler
+      virtual void distributeMemory();
+
+      // Add the four boundary edges to graph as independent tasks; returns the added tasks,
+      // errors are reported to results
+      std::vector<TileGraph::t_node> addBoundaryTasks( TileGraph                             &graph
+                                                     , t_matrices                             U
+                                                     , TileResults                           &results
+                                                     , const std::vector<TileGraph::t_node>  &dependencies = {}
+                                                     );
+
+      // Stage update of columns [iFirst,iLast) of the interior of U
+      void applyStageUpdate( const t_stageUpdate  &stage
+                           , t_matrices            U
+                           , size_t                iFirst
+                           , size_t                iLast
+                           );
+
+      t_status applyBoundaryLeft( t_matrices U );
+      t_status applyBoundaryRight( t_matrices U );
+      t_status applyBoundaryBottom( t_matrices U );
+      t_status applyBoundaryTop( t_matrices U );
+      // Ghost rows of one-dimensional problems, below (bottom) or above the interior
+      void applyUniformRows( t_matrices U
+                           , bool       bottom );
+      // Ghost rows below the mirror plane, reflected with the parities of the variables
+      void applyMirrorRows( t_matrices U );
+
    private:
 };
 
@@ -31,6 +31,14 @@ SpatialMethodCentralFD2::~SpatialMethodCentralFD2
    freeMatrices( G );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodCentralFD2::distributeMemory
+   (
+){
+   scheduler->distribute( F, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( G, PRB_DIM, nxTotal, nyTotal );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 size_t SpatialMethodCentralFD2::requiredBufferWidth
    (
@@ -122,7 +130,7 @@ t_status SpatialMethodCentralFD2::integrate
          double cs  = sqrt(cs2);   // slow magnetosonic speed
          double cf2 = ct2 + sqrt(ctemp); if( cf2 < 0.0 ) cf2 = 0.0;
          double cf  = sqrt(cf2);   // fast magnetosonic speed
-         cxmax = std::max({ cxmax, u - cf, u - ca, u - cs, u, u + cs, u + ca, u + cf });
+         cxmax = std::max( cxmax, waveScaleX[i]*std::max({ u - cf, u - ca, u - cs, u, u + cs, u + ca, u + cf }) );
 
          // y direction
          ca2 = by*by/r;
@@ -133,7 +141,7 @@ t_status SpatialMethodCentralFD2::integrate
          cs  = sqrt(cs2);   // slow magnetosonic speed
          cf2 = ct2 + sqrt(ctemp); if( cf2 < 0.0 ) cf2 = 0.0;
          cf  = sqrt(cf2);   // fast magnetosonic speed
-         cymax = std::max({ cymax, v - cf, v - ca, v - cs, v, v + cs, v + ca, v + cf });
+         cymax = std::max( cymax, waveScaleY[j]*std::max({ v - cf, v - ca, v - cs, v, v + cs, v + ca, v + cf }) );
       }
    }
 
@@ -144,8 +152,8 @@ t_status SpatialMethodCentralFD2::integrate
    for( auto k = size_t{0}; k < PRB_DIM; k++ ){
       for( auto i = nxFirst; i < nxLast; i++ ){
          for( auto j = nyFirst; j < nyLast; j++ ){
-            UL[k][i][j] = -(1.0/(2.0*dx)) * ( F[k][i+1][j] - F[k][i-1][j] )
-                          -(1.0/(2.0*dy)) * ( G[k][i][j+1] - G[k][i][j-1] );
+            UL[k][i][j] = -dxCentralInv[i] * ( F[k][i+1][j] - F[k][i-1][j] )
+                          -dyCentralInv[j] * ( G[k][i][j+1] - G[k][i][j-1] );
          }
       }
    }
@@ -25,6 +25,7 @@ class SpatialMethodCentralFD2 : public SpatialIntegrationMethod
       static size_t requiredBufferWidth();
 
    protected:
+      void distributeMemory() override;
 
    private:
       static const size_t minimumBufferWidth = 1;
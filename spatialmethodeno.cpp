@@ -1,6 +1,12 @@
 #include "spatialmethodeno.hpp"
 
 #include <stdexcept>
+#include <cstring>
+
+// (definitions of the coefficient tables, which enoReconstruct takes the address of)
+constexpr double t_enoStencil<2>::c[3][2];
+constexpr double t_enoStencil<3>::c[4][3];
+constexpr double t_enoStencil<4>::c[5][4];
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 SpatialMethodEno::SpatialMethodEno
@@ -11,21 +17,28 @@ SpatialMethodEno::SpatialMethodEno
    , double       dy
    , t_boundary   boundary
    , double       gamma
+   , EnoSystem    system
 )
    : SpatialIntegrationMethod{ nx, ny, bufferWidth, dx, dy, boundary, gamma }
+   , enoSystem{ system }
+   , systemSize{ system == EnoSystem::Planar ? t_enoSystem<EnoSystem::Planar>::size
+               : system == EnoSystem::Hydro  ? t_enoSystem<EnoSystem::Hydro>::size
+               :                               t_enoSystem<EnoSystem::MHD>::size }
 {
    if( bufferWidth < minimumBufferWidth ){
       throw std::domain_error( "Buffer is too small for ENO;"
                                " need at least 2 extra grids" );
    }
 
-   F = createMatrices( PRB_DIM, nxTotal, nyTotal );
-   G = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   F = createMatrices( systemSize, nxTotal, nyTotal );
+   G = createMatrices( systemSize, nxTotal, nyTotal );
 
    _cx = createMatrices( PRB_DIM, nxTotal, nyTotal );
    _cy = createMatrices( PRB_DIM, nxTotal, nyTotal );
    _LUx = createMatrices( PRB_DIM, nxTotal, nyTotal );
    _LUy = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   eigenCaches.resize( scheduler->getThreadCount()
+                     , t_eigenCache{ std::vector<t_eigenSlot>( 2*nyTotal, t_eigenSlot{} ), 0, 0 } );
    for( auto k = 0; k < PRB_DIM; k++ ){
       for( auto i = size_t{0}; i < nxTotal; i++ ){
          for( auto j = size_t{0}; j < nyTotal; j++ ){
@@ -51,6 +64,82 @@ SpatialMethodEno::~SpatialMethodEno
    freeMatrices( _LUy );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodEno::distributeMemory
+   (
+){
+   scheduler->distribute( F, systemSize, nxTotal, nyTotal );
+   scheduler->distribute( G, systemSize, nxTotal, nyTotal );
+   scheduler->distribute( _cx, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( _cy, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( _LUx, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( _LUy, PRB_DIM, nxTotal, nyTotal );
+
+   // (new caches start empty)
+   eigenCaches.resize( std::max( eigenCaches.size(), scheduler->getThreadCount() )
+                     , t_eigenCache{ std::vector<t_eigenSlot>( 2*nyTotal, t_eigenSlot{} ), 0, 0 } );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t SpatialMethodEno::requiredBufferWidth
+   (
+){
+   return minimumBufferWidth;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialMethodEno::setEigensystemCache
+   ( bool cache
+){
+   cacheEigensystems = cache;
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodEno::printStatistics
+   ( std::ostream &out
+) const {
+   auto lookups = size_t{0};
+   auto hits    = size_t{0};
+   for( const auto &cache : eigenCaches ){
+      lookups += cache.lookups;
+      hits    += cache.hits;
+   }
+   if( cacheEigensystems && lookups > 0 ){
+      out << " - Eigensystem cache  : " << 100.0*hits/lookups
+          << "% of the eigensystems reused instead of computed\n";
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialMethodEno::setAlfvenSpeedLimit
+   ( double cLimit
+){
+   alfvenLimitInv2 = ( cLimit > 0.0 ) ? 1.0/(cLimit*cLimit) : 0.0;
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialMethodEno::setOneDimensional
+   ( bool oneDimensional
+){
+   // the fluxes G are not calculated, the characteristics in y-direction stay zero
+   this->oneDimensional = oneDimensional;
+
+   for( auto k = 0; k < PRB_DIM; k++ ){
+      for( auto i = size_t{0}; i < nxTotal; i++ ){
+         for( auto j = size_t{0}; j < nyTotal; j++ ){
+            _cy[k][i][j]  = 0.0;
+            _LUy[k][i][j] = 0.0;
+         }
+      }
+   }
+
+   return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 bool SpatialMethodEno::getCharacteristicsX
    ( t_matrices cx
@@ -86,46 +175,281 @@ bool SpatialMethodEno::getCharacteristicsY
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
 void SpatialMethodEno::updateFluxes
    ( const t_matrices U
+   , size_t           iFirst
+   , size_t           iLast
+){
+   double Up[PRB_DIM];
+
+   for( auto i = iFirst; i < iLast; i++ ){
+      for( auto j = rowFirst-bufferWidth; j < rowLast+bufferWidth; j++ ){
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            Up[k] = U[k][i][j];
+         updateFluxesAt<S>( Up, i, j );
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
+void SpatialMethodEno::updateFluxesAt
+   ( const double Up[PRB_DIM]
+   , size_t       i
+   , size_t       j
+){
+   auto r  = Up[0];
+   auto mx = Up[1]; auto u = mx / r;
+   auto my = Up[2]; auto v = my / r;
+   auto mz = Up[3]; auto w = mz / r;
+   auto bx = Up[4];
+   auto by = Up[5];
+   auto bz = Up[6];
+   auto e  = Up[7];
+   auto uu =  u*u  +  v*v  +  w*w;
+   auto ub =  u*bx +  v*by +  w*bz;
+   auto bb = bx*bx + by*by + bz*bz;
+   auto p = (gamma-1.0)*(e-0.5*r*uu-0.5*bb);
+   auto ptot = p + 0.5*bb;
+
+   if( S == EnoSystem::Hydro ){
+      // bx = by = bz = 0
+      /* rho */ F[0][i][j] = mx;
+      /* mx  */ F[1][i][j] = mx*u + p;
+      /* my  */ F[2][i][j] = my*u;
+      /* mz  */ F[3][i][j] = mz*u;
+      /* e   */ F[4][i][j] = (e+p)*u;
+
+      /* rho */ G[0][i][j] = my;
+      /* mx  */ G[1][i][j] = mx*v;
+      /* my  */ G[2][i][j] = my*v + p;
+      /* mz  */ G[3][i][j] = mz*v;
+      /* e   */ G[4][i][j] = (e+p)*v;
+      return;
+   }
+
+   if( S == EnoSystem::Planar ){
+      // mz = bz = 0
+      /* rho */ F[0][i][j] = mx;
+      /* mx  */ F[1][i][j] = mx*u - bx*bx + ptot;
+      /* my  */ F[2][i][j] = my*u - bx*by;
+      /* bx  */ F[3][i][j] = 0;
+      /* by  */ F[4][i][j] = by*u - bx*v;
+      /* e   */ F[5][i][j] = (e+ptot)*u - bx*ub;
+
+      /* rho */ G[0][i][j] = my;
+      /* mx  */ G[1][i][j] = mx*v - by*bx;
+      /* my  */ G[2][i][j] = my*v - by*by + ptot;
+      /* bx  */ G[3][i][j] = bx*v - by*u;
+      /* by  */ G[4][i][j] = 0;
+      /* e   */ G[5][i][j] = (e+ptot)*v - by*ub;
+      return;
+   }
+
+   /* rho */ F[0][i][j] = mx;
+   /* mx  */ F[1][i][j] = mx*u - bx*bx + ptot;
+   /* my  */ F[2][i][j] = my*u - bx*by;
+   /* mz  */ F[3][i][j] = mz*u - bx*bz;
+   /* bx  */ F[4][i][j] = 0;
+   /* by  */ F[5][i][j] = by*u - bx*v;
+   /* bz  */ F[6][i][j] = bz*u - bx*w;
+   /* e   */ F[7][i][j] = (e+ptot)*u - bx*ub;
+
+   /* rho */ G[0][i][j] = my;
+   /* mx  */ G[1][i][j] = mx*v - by*bx;
+   /* my  */ G[2][i][j] = my*v - by*by + ptot;
+   /* mz  */ G[3][i][j] = mz*v - by*bz;
+   /* bx  */ G[4][i][j] = bx*v - by*u;
+   /* by  */ G[5][i][j] = 0;
+   /* bz  */ G[6][i][j] = bz*v - by*w;
+   /* e   */ G[7][i][j] = (e+ptot)*v - by*ub;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodEno::applyAlfvenLimit
+   ( const t_matrices U
+   , t_matrices       UL
+   , size_t           iFirst
+   , size_t           iLast
 ){
-   for( auto i = size_t{0}; i < nxTotal; i++ ){
-      for( auto j = size_t{0}; j < nyTotal; j++ ){
+   // Maxwell stress part of the momentum fluxes F and G at point (i,j)
+   auto stress = [U]( size_t i, size_t j, double mF[VEL_DIM], double mG[VEL_DIM] ){
+      auto bx = U[4][i][j];
+      auto by = U[5][i][j];
+      auto bz = U[6][i][j];
+      auto pm = 0.5*( bx*bx + by*by + bz*bz );
+      mF[0] = pm - bx*bx; mF[1] =    - bx*by; mF[2] = - bx*bz;
+      mG[0] =    - by*bx; mG[1] = pm - by*by; mG[2] = - by*bz;
+   };
+
+   double mFl[VEL_DIM], mFr[VEL_DIM], mGd[VEL_DIM], mGu[VEL_DIM], unused[VEL_DIM];
+   // (no y-derivatives in one-dimensional problems)
+   auto noY = oneDimensional;
+
+   for( auto i = iFirst; i < iLast; i++ ){
+      for( auto j = rowFirst; j < rowLast; j++ ){
          auto r  = U[0][i][j];
-         auto mx = U[1][i][j]; auto u = mx / r;
-         auto my = U[2][i][j]; auto v = my / r;
-         auto mz = U[3][i][j]; auto w = mz / r;
-         auto bx = U[4][i][j];
-         auto by = U[5][i][j];
-         auto bz = U[6][i][j];
-         auto e  = U[7][i][j];
-         auto uu =  u*u  +  v*v  +  w*w;
-         auto ub =  u*bx +  v*by +  w*bz;
-         auto bb = bx*bx + by*by + bz*bz;
-         auto p = (gamma-1.0)*(e-0.5*r*uu-0.5*bb);
-         auto ptot = p + 0.5*bb;
-
-         /* rho */ F[0][i][j] = mx;
-         /* mx  */ F[1][i][j] = mx*u - bx*bx + ptot;
-         /* my  */ F[2][i][j] = my*u - bx*by;
-         /* mz  */ F[3][i][j] = mz*u - bx*bz;
-         /* bx  */ F[4][i][j] = 0;
-         /* by  */ F[5][i][j] = by*u - bx*v;
-         /* bz  */ F[6][i][j] = bz*u - bx*w;
-         /* e   */ F[7][i][j] = (e+ptot)*u - bx*ub;
-
-         /* rho */ G[0][i][j] = my;
-         /* mx  */ G[1][i][j] = mx*v - by*bx;
-         /* my  */ G[2][i][j] = my*v - by*by + ptot;
-         /* mz  */ G[3][i][j] = mz*v - by*bz;
-         /* bx  */ G[4][i][j] = bx*v - by*u;
-         /* by  */ G[5][i][j] = 0;
-         /* bz  */ G[6][i][j] = bz*v - by*w;
-         /* e   */ G[7][i][j] = (e+ptot)*v - by*ub;
+         auto bb = U[4][i][j]*U[4][i][j] + U[5][i][j]*U[5][i][j] + U[6][i][j]*U[6][i][j];
+         auto rm = r + bb*alfvenLimitInv2;
+         auto reduction = 1.0 - r/rm;
+
+         stress( i-1, j, mFl, unused );
+         stress( i+1, j, mFr, unused );
+         stress( i, j-1, unused, mGd );
+         stress( i, j+1, unused, mGu );
+
+         auto work = 0.0;
+         for( auto k = size_t{0}; k < VEL_DIM; k++ ){
+            auto force = -dxCentralInv[i]*( mFr[k] - mFl[k] ) - ( noY ? 0.0 : dyCentralInv[j] )*( mGu[k] - mGd[k] );
+            UL[1+k][i][j] -= reduction*force;
+            work += U[1+k][i][j]/r * reduction*force;
+         }
+         UL[7][i][j] -= work;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
+void SpatialMethodEno::updateGhostFluxes
+   ( const t_matrices U
+   , size_t           iFirst
+   , size_t           iLast
+){
+   double Up[PRB_DIM];
+
+   for( auto i = iFirst; i < iLast; i++ ){
+      for( auto j = rowFirst-bufferWidth; j < rowLast+bufferWidth; j++ ){
+         // skip interior
+         if( i >= nxFirst && i < nxLast && j >= rowFirst && j < rowLast ) continue;
+
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            Up[k] = U[k][i][j];
+         updateFluxesAt<S>( Up, i, j );
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
+void SpatialMethodEno::updateStageAndFluxes
+   ( const t_stageUpdate  &stage
+   , t_matrices            U
+   , size_t                iFirst
+   , size_t                iLast
+){
+   double Up[PRB_DIM];
+
+   iFirst = std::max( iFirst, nxFirst );
+   iLast  = std::min( iLast,  nxLast  );
+
+   for( auto i = iFirst; i < iLast; i++ ){
+      for( auto j = rowFirst; j < rowLast; j++ ){
+         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+            if( stage.U1 ){
+               Up[k] = stage.a0*stage.U0[k][i][j] + stage.a1*stage.U1[k][i][j] + stage.c*stage.L[k][i][j];
+            } else {
+               Up[k] = stage.a0*stage.U0[k][i][j] + stage.c*stage.L[k][i][j];
+            }
+            U[k][i][j] = Up[k];
+         }
+         updateFluxesAt<S>( Up, i, j );
       }
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
+void SpatialMethodEno::addStateTasks
+   ( TileGraph                      &graph
+   , t_matrices                      U
+   , const t_stageUpdate            *stage
+   , TileResults                    &boundaryResults
+   , const std::function<bool()>    &failed
+   , std::vector<TileGraph::t_node> &stateReady
+   , std::vector<TileGraph::t_node> &fluxesReady
+){
+   if( !stage ){
+      // boundary conditions, then fluxes of the whole grid
+      stateReady = addBoundaryTasks( graph, U, boundaryResults );
+      fluxesReady = { graph.addTask( 0, nxTotal, [=]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         if( failed() ) return;
+         updateFluxes<S>( U, iFirst, iLast );
+      }, stateReady ) };
+   } else {
+      // stage update and fluxes of the interior in one sweep, then boundary conditions,
+      // then fluxes of the ghost cells
+      auto interior = graph.addTask( nxFirst, nxLast, [=]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         updateStageAndFluxes<S>( *stage, U, iFirst, iLast );
+      } );
+      stateReady = addBoundaryTasks( graph, U, boundaryResults, { interior } );
+      fluxesReady = { graph.addTask( 0, nxTotal, [=]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         if( failed() ) return;
+         updateGhostFluxes<S>( U, iFirst, iLast );
+      }, stateReady ), interior };
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialMethodEno::getRowDtIdeal
+   ( const t_matrices     U
+   , std::vector<double> &dtIdeal
+){
+   TileResults results{ scheduler->getThreadCount() };
+
+   dtIdeal.assign( nyTotal, 0.0 );
+   // wave speeds at the faces between neighbouring interior points, as in the numerical fluxes
+   scheduler->forTiles( nyFirst, nyLast, [&]( size_t jFirst, size_t jLast, size_t thread ){
+      double tU1[PRB_DIM], tU2[PRB_DIM], tlambda[PRB_DIM];
+
+      for( auto j = jFirst; j < jLast; j++ ){
+         auto maxWaveSpeedX = double{0.0};
+         auto maxWaveSpeedY = double{0.0};
+         for( auto i = nxFirst; i < nxLast; i++ ){
+            auto pointStatus = t_status{ false, ReturnStatus::OK, std::string{} };
+
+            // faces i+1/2 and j-1/2, j+1/2
+            if( i+1 < nxLast ){
+               for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+                  tU1[k] = U[k][i][j];
+                  tU2[k] = U[k][i+1][j];
+               }
+               pointStatus = getEigenvaluesBetween( tU1, tU2, tlambda );
+               for( auto k = size_t{0}; k < PRB_DIM && !pointStatus.isError; k++ )
+                  maxWaveSpeedX = std::max( maxWaveSpeedX, fabs(tlambda[k])*faceScaleX( i ) );
+            }
+            for( auto jj = std::max( j, nyFirst+1 )-1; jj <= j && jj+1 < nyLast && !pointStatus.isError; jj++ ){
+               for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+                  tU1[k] = U[k][i][jj];
+                  tU2[k] = U[k][i][jj+1];
+               }
+               std::swap( tU1[1], tU1[2] ); std::swap( tU1[4], tU1[5] );
+               std::swap( tU2[1], tU2[2] ); std::swap( tU2[4], tU2[5] );
+               pointStatus = getEigenvaluesBetween( tU1, tU2, tlambda );
+               for( auto k = size_t{0}; k < PRB_DIM && !pointStatus.isError; k++ )
+                  maxWaveSpeedY = std::max( maxWaveSpeedY, fabs(tlambda[k])*faceScaleY( jj ) );
+            }
+            if( pointStatus.isError ){
+               pointStatus.message += std::string{}
+                                   + "\n! SpatialMethodEno::getRowDtIdeal "
+                                   + "( i = " + std::to_string( int(i)-int(nxFirst) )
+                                   + ", j = " + std::to_string( int(j)-int(nyFirst) ) + " )";
+               results.setError( thread, j*nxTotal+i, pointStatus );
+               return;
+            }
+         }
+         dtIdeal[j] = std::min( dx/maxWaveSpeedX, dy/maxWaveSpeedY );
+      }
+   } );
+
+   if( results.failed() ){
+      return results.getError();
+   }
+
+   return { false, ReturnStatus::OK, "" };
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 t_status SpatialMethodEno::getEigenvaluesAt
    ( const double U[PRB_DIM]
@@ -179,13 +503,14 @@ t_status SpatialMethodEno::getEigenvaluesAt
       }
    }
 
-   // speeds
+   // speeds; the magnetic speeds use the Boris inertia rm, which equals r without a limit
    auto a2  = gamma*p / r;
    if( a2 < 0.0 ) a2 = 0.0;
    //auto a   = sqrt(a2);    // sound speed
-   auto ca2 = bx*bx/r;
+   auto rm  = r + bb*alfvenLimitInv2;
+   auto ca2 = bx*bx/rm;
    auto ca  = sqrt(ca2);   // Alfven speed
-   auto c2  = 0.5*(bb/r+a2);
+   auto c2  = 0.5*(bb/rm+a2);
    auto ctemp = c2*c2-a2*ca2; if( ctemp < 0.0 ) ctemp = 0.0;
    auto cs2 = c2 - sqrt(ctemp); if( cs2 < 0.0 ) cs2 = EPS;
    auto cs  = sqrt(cs2);   // slow magnetosonic speed
@@ -258,13 +583,14 @@ t_status SpatialMethodEno::getEigenvaluesBetween
       }
    }
 
-   // speeds
+   // speeds; the magnetic speeds use the Boris inertia rm, which equals r without a limit
    auto a2  = gamma*p / r;
    if( a2 < 0.0 ) a2 = 0.0;
    //auto a   = sqrt(a2);    // sound speed
-   auto ca2 = bx*bx/r;
+   auto rm  = r + bb*alfvenLimitInv2;
+   auto ca2 = bx*bx/rm;
    auto ca  = sqrt(ca2);   // Alfven speed
-   auto c2  = 0.5*(bb/r+a2);
+   auto c2  = 0.5*(bb/rm+a2);
    auto ctemp = c2*c2-a2*ca2; if( ctemp < 0.0 ) ctemp = 0.0;
    auto cs2 = c2 - sqrt(ctemp); if( cs2 < 0.0 ) cs2 = EPS;
    auto cs  = sqrt(cs2);   // slow magnetosonic speed
@@ -285,6 +611,7 @@ t_status SpatialMethodEno::getEigenvaluesBetween
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
 t_status SpatialMethodEno::getEigensF
    ( double U1[PRB_DIM]
    , double U2[PRB_DIM]
@@ -292,6 +619,10 @@ t_status SpatialMethodEno::getEigensF
    , double lv[PRB_DIM][PRB_DIM]
    , double rv[PRB_DIM][PRB_DIM]
 ){
+   if( S == EnoSystem::Hydro ){
+      return getEigensHydroF( U1, U2, lambda, lv, rv );
+   }
+
    auto status = t_status{ false, ReturnStatus::OK, std::string{} };
 
    // half-point values
@@ -339,13 +670,15 @@ t_status SpatialMethodEno::getEigensF
       }
    }
 
-   // speeds
+   // speeds; the magnetic speeds (and the normalization of B in the eigenvectors) use the
+   // Boris inertia rm, which equals r without a limit
    auto a2  = gamma*p / r;
    if( a2 < 0.0 ) a2 = 0.0;
    auto a   = sqrt(a2);    // sound speed
-   auto ca2 = bx*bx/r;
+   auto rm  = r + bb*alfvenLimitInv2;
+   auto ca2 = bx*bx/rm;
    auto ca  = sqrt(ca2);   // Alfven speed
-   auto c2  = 0.5*(bb/r+a2);
+   auto c2  = 0.5*(bb/rm+a2);
    auto ctemp = c2*c2-a2*ca2; if( ctemp < 0.0 ) ctemp = 0.0;
    auto cs2 = c2 - sqrt(ctemp); if( cs2 < 0.0 ) cs2 = EPS;
    auto cs  = sqrt(cs2);   // slow magnetosonic speed
@@ -358,7 +691,7 @@ t_status SpatialMethodEno::getEigensF
 #endif // DEBUG_MIDPOINT_EIGENVALUES
 
    // other
-   auto rroot   = sqrt( r );
+   auto rroot   = sqrt( rm );
    auto bperp2  = by*by + bz*bz;
    auto sgnbx   = (bx<0.0) ? -1.0 : 1.0;//( (bx>0.0) ? 1 : 0 );
    auto alphaf2 = ( (bperp2<EPS) && EPS_EQUAL(ca2,a2) ) ? 1 : (cf2-ca2) / (cf2-cs2);
@@ -367,8 +700,9 @@ t_status SpatialMethodEno::getEigensF
    auto alphas2 = ( (bperp2<EPS) && EPS_EQUAL(ca2,a2) ) ? 1 : (cf2- a2) / (cf2-cs2);
         alphas2 = alphas2 < 0.0 ? 0.0 : alphas2; // hack for cf ~ a
    auto alphas  = sqrt( alphas2 );
-   auto betay   = bperp2 > EPS ? by / sqrt( bperp2 ) : 1.0/sqrt(2.0);
-   auto betaz   = bperp2 > EPS ? bz / sqrt( bperp2 ) : 1.0/sqrt(2.0);
+   // (in the planar system, the transverse field is along y; B_perp = 0 must not couple mz and bz)
+   auto betay   = bperp2 > EPS ? by / sqrt( bperp2 ) : ( S == EnoSystem::Planar ? 1.0 : 1.0/sqrt(2.0) );
+   auto betaz   = bperp2 > EPS ? bz / sqrt( bperp2 ) : ( S == EnoSystem::Planar ? 0.0 : 1.0/sqrt(2.0) );
    auto theta1  = 1.0 / ( alphaf2*a2*(cf2-(gamma-2.0)/(gamma-1.0)*a2) + alphas2*cf2*(cs2-(gamma-2.0)/(gamma-1.0)*a2) );
    auto theta2  = 1.0 / ( alphaf2*cf*a*sgnbx + alphas2*cs*ca*sgnbx );
 
@@ -400,15 +734,17 @@ t_status SpatialMethodEno::getEigensF
    rv[0][6] =   alphas*betaz*cf / rroot;
    rv[0][7] = 0.5*alphaf*uu + alphaf*cf2/(gamma-1.0) - alphaf*cf*u + alphas*ca*sgnbx*(betay*v+betaz*w) + (gamma-2.0)/(gamma-1.0)*alphaf*(cf2-a2);
 
-   // a2 = u - ca (Alfven)
-   rv[1][0] = 0;
-   rv[1][1] = 0;
-   rv[1][2] =   betaz*sgnbx;
-   rv[1][3] = - betay*sgnbx;
-   rv[1][4] = 0;
-   rv[1][5] =   betaz/rroot;
-   rv[1][6] = - betay/rroot;
-   rv[1][7] =   (betaz*v-betay*w)*sgnbx;
+   // a2 = u - ca (Alfven) - not in the planar system
+   if( S == EnoSystem::MHD ){
+      rv[1][0] = 0;
+      rv[1][1] = 0;
+      rv[1][2] =   betaz*sgnbx;
+      rv[1][3] = - betay*sgnbx;
+      rv[1][4] = 0;
+      rv[1][5] =   betaz/rroot;
+      rv[1][6] = - betay/rroot;
+      rv[1][7] =   (betaz*v-betay*w)*sgnbx;
+   }
 
    // a3 = u - cs (slow magnetosonic)
    rv[2][0] =   alphas;
@@ -440,15 +776,17 @@ t_status SpatialMethodEno::getEigensF
    rv[4][6] = - alphaf*betaz*a2 / (cf*rroot);
    rv[4][7] = 0.5*alphas*uu + alphas*cs2/(gamma-1.0) + alphas*cs*u + alphaf*a*sgnbx*(betay*v+betaz*w) + (gamma-2.0)/(gamma-1.0)*alphas*(cs2-a2);
 
-   // a6 = u + ca (Alfven)
-   rv[5][0] = 0;
-   rv[5][1] = 0;
-   rv[5][2] = - betaz*sgnbx;
-   rv[5][3] = + betay*sgnbx;
-   rv[5][4] = 0;
-   rv[5][5] =   betaz/rroot;
-   rv[5][6] = - betay/rroot;
-   rv[5][7] = - (betaz*v-betay*w)*sgnbx;
+   // a6 = u + ca (Alfven) - not in the planar system
+   if( S == EnoSystem::MHD ){
+      rv[5][0] = 0;
+      rv[5][1] = 0;
+      rv[5][2] = - betaz*sgnbx;
+      rv[5][3] = + betay*sgnbx;
+      rv[5][4] = 0;
+      rv[5][5] =   betaz/rroot;
+      rv[5][6] = - betay/rroot;
+      rv[5][7] = - (betaz*v-betay*w)*sgnbx;
+   }
 
    // a7 = u + cf (fast magnetosonic)
    rv[6][0] =   alphaf;
@@ -481,15 +819,17 @@ t_status SpatialMethodEno::getEigensF
    lv[0][6] =  0.5*theta1*alphas*betaz*cf*rroot*(cs2-(gamma-2.0)/(gamma-1.0)*a2);
    lv[0][7] =  0.5*theta1*alphaf*a2;
 
-   // a2 = u - ca (Alfven)
-   lv[1][0] = -0.5*(betaz*v-betay*w)*sgnbx;
-   lv[1][1] = 0;
-   lv[1][2] =  0.5*betaz*sgnbx;
-   lv[1][3] = -0.5*betay*sgnbx;
-   lv[1][4] = 0;
-   lv[1][5] =  0.5*betaz*rroot;
-   lv[1][6] = -0.5*betay*rroot;
-   lv[1][7] = 0;
+   // a2 = u - ca (Alfven) - not in the planar system
+   if( S == EnoSystem::MHD ){
+      lv[1][0] = -0.5*(betaz*v-betay*w)*sgnbx;
+      lv[1][1] = 0;
+      lv[1][2] =  0.5*betaz*sgnbx;
+      lv[1][3] = -0.5*betay*sgnbx;
+      lv[1][4] = 0;
+      lv[1][5] =  0.5*betaz*rroot;
+      lv[1][6] = -0.5*betay*rroot;
+      lv[1][7] = 0;
+   }
 
    // a3 = u - cs (slow magnetosonic)
    lv[2][0] = 0.25*theta1*alphas*cf2*uu + 0.5*theta2*( alphas*ca*u*sgnbx + alphaf*cf*(betay*v+betaz*w) );
@@ -521,15 +861,17 @@ t_status SpatialMethodEno::getEigensF
    lv[4][6] = -0.5*theta1*alphaf*betaz*cf*rroot*(cf2-(gamma-2.0)/(gamma-1.0)*a2);
    lv[4][7] =  0.5*theta1*alphas*cf2;
 
-   // a6 = u + ca
-   lv[5][0] = +0.5*(betaz*v-betay*w)*sgnbx;
-   lv[5][1] = 0;
-   lv[5][2] = -0.5*betaz*sgnbx;
-   lv[5][3] =  0.5*betay*sgnbx;
-   lv[5][4] = 0;
-   lv[5][5] =  0.5*betaz*rroot;
-   lv[5][6] = -0.5*betay*rroot;
-   lv[5][7] = 0;
+   // a6 = u + ca - not in the planar system
+   if( S == EnoSystem::MHD ){
+      lv[5][0] = +0.5*(betaz*v-betay*w)*sgnbx;
+      lv[5][1] = 0;
+      lv[5][2] = -0.5*betaz*sgnbx;
+      lv[5][3] =  0.5*betay*sgnbx;
+      lv[5][4] = 0;
+      lv[5][5] =  0.5*betaz*rroot;
+      lv[5][6] = -0.5*betay*rroot;
+      lv[5][7] = 0;
+   }
 
    // a7 = u + cf
    lv[6][0] = 0.25*theta1*alphaf*a2*uu - 0.5*theta2*( alphaf*a*u*sgnbx - alphas*cs*(betay*v+betaz*w) );
@@ -571,6 +913,142 @@ t_status SpatialMethodEno::getEigensF
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialMethodEno::getEigensHydroF
+   ( double U1[PRB_DIM]
+   , double U2[PRB_DIM]
+   , double lambda[PRB_DIM]
+   , double lv[PRB_DIM][PRB_DIM]
+   , double rv[PRB_DIM][PRB_DIM]
+){
+   typedef t_enoSystem<EnoSystem::Hydro> System;
+
+   auto status = t_status{ false, ReturnStatus::OK, std::string{} };
+
+   // half-point values
+   auto r  = 0.5 * ( U1[0] + U2[0] );
+   auto u  = 0.5 * ( U1[1]/U1[0] + U2[1]/U2[0] );
+   auto v  = 0.5 * ( U1[2]/U1[0] + U2[2]/U2[0] );
+   auto w  = 0.5 * ( U1[3]/U1[0] + U2[3]/U2[0] );
+
+   if( r <= 0.0 ){
+      return { true, ReturnStatus::ErrorNegativeDensity
+             , "negative density encountered\n! getEigensHydroF" };
+   }
+
+   auto uu = u*u + v*v + w*w;
+
+   // half-point pressure
+   auto mml = U1[1]*U1[1] + U1[2]*U1[2] + U1[3]*U1[3];
+   auto mmr = U2[1]*U2[1] + U2[2]*U2[2] + U2[3]*U2[3];
+   auto pl = (gamma-1.0)*( U1[7] - 0.5*mml/U1[0] );
+   auto pr = (gamma-1.0)*( U2[7] - 0.5*mmr/U2[0] );
+   auto p  = 0.5 * ( pl + pr );
+   if( p < 0.0 ){
+      if( breakOnNegativePressure ){
+         return { true, ReturnStatus::ErrorNegativePressure
+                , "negative pressure encountered\n! getEigensHydroF" };
+      } else {
+         p = 0.0;
+
+         status.status = ReturnStatus::ErrorNegativePressure;
+         status.message = "negative pressure encountered\n! getEigensHydroF";
+         if( !shownPressureWarning ){
+            ERROUT << "WARNING: getEigensHydroF: Negative pressure encountered!\n"
+                   << "         Results from this point on are suspect.\n"
+                   << "         Simulation resumed with pressure forced to zero.\n";
+         }
+      }
+   }
+
+   // sound speed and enthalpy; a = 0 (zero pressure) is kept finite for the left eigenvectors
+   auto a2 = std::max( gamma*p/r, EPS );
+   auto a  = sqrt( a2 );
+   auto h  = a2/(gamma-1.0) + 0.5*uu;
+   auto b1 = (gamma-1.0)/a2;
+   auto b2 = 0.5*b1*uu;
+
+   /* eigenvalues */
+   lambda[0] = u - a;
+   lambda[1] = u;
+   lambda[2] = u;
+   lambda[3] = u;
+   lambda[4] = u;
+   lambda[5] = u;
+   lambda[6] = u + a;
+   lambda[7] = 0;
+
+   // right (columns) and left (rows) eigenvectors over rho, mx, my, mz, e
+   const double r5[System::size][System::size] = {
+      { 1.0, u-a, v,   w,   h-u*a  },   // u - a (sound)
+      { 0.0, 0.0, 1.0, 0.0, v      },   // u (shear, v)
+      { 1.0, u,   v,   w,   0.5*uu },   // u (entropy)
+      { 0.0, 0.0, 0.0, 1.0, w      },   // u (shear, w)
+      { 1.0, u+a, v,   w,   h+u*a  } }; // u + a (sound)
+   const double l5[System::size][System::size] = {
+      { 0.5*(b2+u/a), -0.5*(b1*u+1.0/a), -0.5*b1*v, -0.5*b1*w,  0.5*b1 },
+      { -v,           0.0,               1.0,       0.0,        0.0    },
+      { 1.0-b2,       b1*u,              b1*v,      b1*w,      -b1     },
+      { -w,           0.0,               0.0,       1.0,        0.0    },
+      { 0.5*(b2-u/a), -0.5*(b1*u-1.0/a), -0.5*b1*v, -0.5*b1*w,  0.5*b1 } };
+
+   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+      for( auto l = size_t{0}; l < PRB_DIM; l++ ){
+         rv[k][l] = 0.0;
+         lv[k][l] = 0.0;
+      }
+   }
+   for( auto k = size_t{0}; k < System::size; k++ ){
+      for( auto l = size_t{0}; l < System::size; l++ ){
+         rv[System::wave( k )][System::var( l )] = r5[k][l];
+         lv[System::wave( k )][System::var( l )] = l5[k][l];
+      }
+   }
+
+   return status;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
+t_status SpatialMethodEno::getEigensFCached
+   ( size_t   thread
+   , size_t   slot
+   , double   U1[PRB_DIM]
+   , double   U2[PRB_DIM]
+   , double   lambda[PRB_DIM]
+   , double (*&lv)[PRB_DIM]
+   , double (*&rv)[PRB_DIM]
+){
+   auto &cache = eigenCaches[thread];
+   auto &entry = cache.slots[slot];
+   lv = entry.lv;
+   rv = entry.rv;
+   if( !cacheEigensystems ){
+      return getEigensF<S>( U1, U2, lambda, lv, rv );
+   }
+
+   cache.lookups++;
+   if( entry.valid
+       && std::memcmp( entry.U1, U1, sizeof(double)*PRB_DIM ) == 0
+       && std::memcmp( entry.U2, U2, sizeof(double)*PRB_DIM ) == 0 ){
+      cache.hits++;
+      std::memcpy( lambda, entry.lambda, sizeof(double)*PRB_DIM );
+      return t_status{ false, ReturnStatus::OK, std::string{} };
+   }
+
+   // the eigenvectors are computed into the slot, and kept if there was no warning
+   auto status = getEigensF<S>( U1, U2, lambda, lv, rv );
+   entry.valid = status.status == ReturnStatus::OK;
+   if( entry.valid ){
+      std::memcpy( entry.U1, U1, sizeof(double)*PRB_DIM );
+      std::memcpy( entry.U2, U2, sizeof(double)*PRB_DIM );
+      std::memcpy( entry.lambda, lambda, sizeof(double)*PRB_DIM );
+   }
+
+   return status;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
 t_status SpatialMethodEno::getEigensG
    ( double U1[PRB_DIM]
    , double U2[PRB_DIM]
@@ -583,7 +1061,7 @@ t_status SpatialMethodEno::getEigensG
    std::swap( U1[4], U1[5] ); std::swap( U2[4], U2[5] );
 
    // get eigens for inverted x and y
-   auto retval = getEigensF( U1, U2, lambda, lv, rv );
+   auto retval = getEigensF<S>( U1, U2, lambda, lv, rv );
    if( retval.status != ReturnStatus::OK ){
       retval.message += "\n! getEigens_G";
    }
@@ -596,3 +1074,19 @@ t_status SpatialMethodEno::getEigensG
 
    return retval;
 }
+
+// instantiations used by the derived methods
+#define ENO_SYSTEM_INSTANTIATIONS( S ) \
+   template void SpatialMethodEno::addStateTasks<S>( TileGraph &, t_matrices, const t_stageUpdate *, TileResults & \
+                                                   , const std::function<bool()> &, std::vector<TileGraph::t_node> & \
+                                                   , std::vector<TileGraph::t_node> & ); \
+   template t_status SpatialMethodEno::getEigensF<S>( double[PRB_DIM], double[PRB_DIM], double[PRB_DIM] \
+                                                    , double[PRB_DIM][PRB_DIM], double[PRB_DIM][PRB_DIM] ); \
+   template t_status SpatialMethodEno::getEigensFCached<S>( size_t, size_t, double[PRB_DIM], double[PRB_DIM], double[PRB_DIM] \
+                                                          , double (*&)[PRB_DIM], double (*&)[PRB_DIM] ); \
+   template t_status SpatialMethodEno::getEigensG<S>( double[PRB_DIM], double[PRB_DIM], double[PRB_DIM] \
+                                                    , double[PRB_DIM][PRB_DIM], double[PRB_DIM][PRB_DIM] );
+ENO_SYSTEM_INSTANTIATIONS( EnoSystem::MHD )
+ENO_SYSTEM_INSTANTIATIONS( EnoSystem::Planar )
+ENO_SYSTEM_INSTANTIATIONS( EnoSystem::Hydro )
+#undef ENO_SYSTEM_INSTANTIATIONS
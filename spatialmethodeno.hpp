@@ -3,9 +3,108 @@
 
 #include "spatialintegrationmethod.hpp"
 
+// Systems integrated by the ENO methods
+enum class EnoSystem {
+   MHD,     // full MHD system
+   Planar,  // reduced system for w = Bz = 0
+   Hydro    // Euler equations for B = 0
+};
+
+// Variables of the system integrated by the ENO methods, and the characteristic fields used
+// in the flux splitting. The full system has all PRB_DIM variables; the planar system, for
+// states with w = Bz = 0 everywhere, drops mz and bz, and with them the Alfven waves (which
+// only carry mz and bz when w = Bz = 0); the hydrodynamic system, for states with B = 0
+// everywhere, drops the magnetic field and uses the eigensystem of the Euler equations.
+// Fluxes are stored per system variable k, which is variable var(k) of U; the variables
+// missing(k), k < PRB_DIM-size, are not in the system and do not change
+template<EnoSystem S>
+struct t_enoSystem;
+
+template<>
+struct t_enoSystem<EnoSystem::MHD> {
+   static constexpr size_t size = PRB_DIM;
+   static constexpr size_t bx   = 4;
+   static constexpr size_t by   = 5;
+
+   // variable of U / characteristic field of system variable k
+   static constexpr size_t var( size_t k ){ return k; }
+   static constexpr size_t wave( size_t k ){ return k; }
+   // k-th variable of U not in the system (none)
+   static constexpr size_t missing( size_t k ){ return k; }
+};
+
+template<>
+struct t_enoSystem<EnoSystem::Planar> {
+   static constexpr size_t size = PRB_DIM-2;
+   static constexpr size_t bx   = 3;
+   static constexpr size_t by   = 4;
+
+   // rho, mx, my, bx, by, e; fast, slow, entropy, slow, fast and the dummy field
+   static constexpr size_t var( size_t k ){ return k < 3 ? k : ( k < 5 ? k+1 : 7 ); }
+   static constexpr size_t wave( size_t k ){ return k == 0 ? 0 : ( k < 4 ? k+1 : ( k == 4 ? 6 : 7 ) ); }
+   // mz, bz
+   static constexpr size_t missing( size_t k ){ return k == 0 ? 3 : 6; }
+};
+
+template<>
+struct t_enoSystem<EnoSystem::Hydro> {
+   static constexpr size_t size = PRB_DIM-3;
+   // (no magnetic field; the y-direction swap of bx and by is a no-op)
+   static constexpr size_t bx   = 1;
+   static constexpr size_t by   = 1;
+
+   // rho, mx, my, mz, e; sound (u-a), shear (v), entropy, shear (w), sound (u+a), stored in
+   // the fields of the fast, Alfven, entropy, Alfven and fast waves they become for B = 0
+   static constexpr size_t var( size_t k ){ return k < 4 ? k : 7; }
+   static constexpr size_t wave( size_t k ){ return k == 0 ? 0 : ( k == 1 ? 1 : ( k == 2 ? 3 : ( k == 3 ? 5 : 6 ) ) ); }
+   // bx, by, bz
+   static constexpr size_t missing( size_t k ){ return 4+k; }
+};
+
+// Coefficients of the ENO reconstruction of order R at the face i+1/2 from the R points of a
+// stencil starting at i-r, r = -1..R-1: c[r+1][m] is the weight of point i-r+m; see Table 2.1
+// in C.-W. Shu, "Essentially Non-Oscillatory and Weighted Essentially Non-Oscillatory Schemes
+// for Hyperbolic Conservation Laws", Lecture Notes in Mathematics 1697, pp.325-432, 1998
+template<size_t R>
+struct t_enoStencil;
+
+template<>
+struct t_enoStencil<2> {
+   static constexpr double c[3][2] = {
+      {  3.0/2.0, -1.0/2.0 },
+      {  1.0/2.0,  1.0/2.0 },
+      { -1.0/2.0,  3.0/2.0 } };
+};
+
+template<>
+struct t_enoStencil<3> {
+   static constexpr double c[4][3] = {
+      { 11.0/6.0, -7.0/6.0,  1.0/3.0 },
+      {  1.0/3.0,  5.0/6.0, -1.0/6.0 },
+      { -1.0/6.0,  5.0/6.0,  1.0/3.0 },
+      {  1.0/3.0, -7.0/6.0, 11.0/6.0 } };
+};
+
+template<>
+struct t_enoStencil<4> {
+   static constexpr double c[5][4] = {
+      { 25.0/12.0, -23.0/12.0,  13.0/12.0,  -1.0/4.0  },
+      {  1.0/4.0,   13.0/12.0,  -5.0/12.0,   1.0/12.0 },
+      { -1.0/12.0,   7.0/12.0,   7.0/12.0,  -1.0/12.0 },
+      {  1.0/12.0,  -5.0/12.0,  13.0/12.0,   1.0/4.0  },
+      { -1.0/4.0,   13.0/12.0, -23.0/12.0,  25.0/12.0 } };
+};
+
 class SpatialMethodEno : public SpatialIntegrationMethod
 {
    public:
+      // Largest ENO order; the stencil of a face of order r has r points on either side of it,
+      // so the per-face arrays have enoStencilSize points, with the face between the points
+      // enoFaceIndex and enoFaceIndex+1
+      static const size_t enoMaxOrder    = 4;
+      static const size_t enoStencilSize = 2*enoMaxOrder;
+      static const size_t enoFaceIndex   = enoMaxOrder-1;
+
       explicit SpatialMethodEno( size_t      nx
                                , size_t      ny
                                , size_t      bufferWidth
@@ -13,11 +112,28 @@ class SpatialMethodEno : public SpatialIntegrationMethod
                                , double      dy
                                , t_boundary  boundary
                                , double      gamma
+                               , EnoSystem   system = EnoSystem::MHD
                                );
       virtual ~SpatialMethodEno();
 
       static size_t requiredBufferWidth();
 
+      t_status getRowDtIdeal( const t_matrices     U
+                            , std::vector<double> &dtIdeal
+                            ) override;
+
+      bool setAlfvenSpeedLimit( double cLimit
+                              ) override;
+
+      bool setOneDimensional( bool oneDimensional
+                            ) override;
+
+      bool setEigensystemCache( bool cache
+                              ) override;
+
+      void printStatistics( std::ostream &out
+                          ) const override;
+
       bool getCharacteristicsX( t_matrices cx
                               , t_matrices LUx
                               ) override;
@@ -26,9 +142,18 @@ class SpatialMethodEno : public SpatialIntegrationMethod
                               ) override;
 
    protected:
+      // integrated system; F and G (and the numerical fluxes of derived classes) only have
+      // systemSize variables
+      const EnoSystem   enoSystem;
+      const size_t      systemSize;
+
       bool breakOnNegativePressure  = false;
       bool shownPressureWarning     = false;
 
+      // 1/c^2 for the Alfven speed limit c, 0 without a limit; the Boris inertia
+      // rm = r + B^2/c^2 replaces r in the magnetic wave speeds, limiting them to c
+      double alfvenLimitInv2        = 0.0;
+
       t_matrices F;
       t_matrices G;
 
@@ -44,8 +169,81 @@ class SpatialMethodEno : public SpatialIntegrationMethod
       t_matrices _LUx;
       t_matrices _LUy;
 
-      // Calculate horizontal and vertical physical fluxes, F and G, from physical values U
-      void updateFluxes( const t_matrices U );
+      // Eigensystem of the last state pair of a cache slot
+      struct t_eigenSlot {
+         bool     valid;
+         double   U1[PRB_DIM];
+         double   U2[PRB_DIM];
+         double   lambda[PRB_DIM];
+         double   lv[PRB_DIM][PRB_DIM];
+         double   rv[PRB_DIM][PRB_DIM];
+      };
+      // Eigensystem cache of a thread: one slot for the F and one for the G faces of each row,
+      // so a face is compared to the previous face of its row, and the lookups and hits
+      struct t_eigenCache {
+         std::vector<t_eigenSlot> slots;
+         size_t   lookups;
+         size_t   hits;
+      };
+      bool                       cacheEigensystems = false;
+      std::vector<t_eigenCache>  eigenCaches;  // per thread of the scheduler
+
+      void distributeMemory() override;
+
+      // Calculate horizontal and vertical physical fluxes, F and G, from physical values U,
+      // for columns [iFirst,iLast) and the active rows with their buffers
+      template<EnoSystem S>
+      void updateFluxes( const t_matrices U
+                       , size_t           iFirst
+                       , size_t           iLast );
+      // Same, only for the cells in columns [iFirst,iLast) outside the active interior
+      template<EnoSystem S>
+      void updateGhostFluxes( const t_matrices U
+                            , size_t           iFirst
+                            , size_t           iLast );
+      // Fluxes F and G at point (i,j) with physical values Up
+      template<EnoSystem S>
+      void updateFluxesAt( const double Up[PRB_DIM]
+                         , size_t       i
+                         , size_t       j );
+      // Boris correction of dU/dt UL of the active interior in columns [iFirst,iLast): the
+      // Lorentz force (from central differences of the Maxwell stress) is reduced by the
+      // factor r/rm, and the energy by the work of the removed force, so the internal energy
+      // evolves as without the limit
+      void applyAlfvenLimit( const t_matrices U
+                           , t_matrices       UL
+                           , size_t           iFirst
+                           , size_t           iLast );
+      // Stage update of the active interior of U in columns [iFirst,iLast), and fluxes of the new values
+      template<EnoSystem S>
+      void updateStageAndFluxes( const t_stageUpdate  &stage
+                               , t_matrices            U
+                               , size_t                iFirst
+                               , size_t                iLast );
+
+      // Add tasks that prepare U for a spatial integration step to graph: apply the
+      // boundary conditions and calculate the physical fluxes, after the stage update of
+      // the interior if stage is given. stateReady are the tasks after which U is complete,
+      // fluxesReady the tasks after which F and G are complete
+      template<EnoSystem S = EnoSystem::MHD>
+      void addStateTasks( TileGraph                      &graph
+                        , t_matrices                      U
+                        , const t_stageUpdate            *stage
+                        , TileResults                    &boundaryResults
+                        , const std::function<bool()>    &failed
+                        , std::vector<TileGraph::t_node> &stateReady
+                        , std::vector<TileGraph::t_node> &fluxesReady );
+
+      // ENO reconstruction of order R at the face between the points i and i+1 of v, from the
+      // stencil grown from the point first (i for the part upwind from the left, i+1 for the
+      // part upwind from the right) to the side of the smaller undivided difference, R-1 times;
+      // ties grow it to the right. dv are the first undivided differences, dv[l] = v[l+1]-v[l];
+      // the points i+1-R to i+R are used
+      template<size_t R>
+      static double enoReconstruct( const double v[]
+                                  , const double dv[]
+                                  , size_t       i
+                                  , size_t       first );
 
       // Eigenvalues lambda at point U
       t_status getEigenvaluesAt( const double   U[PRB_DIM]
@@ -55,21 +253,79 @@ class SpatialMethodEno : public SpatialIntegrationMethod
                                     , const double U2[PRB_DIM]
                                     , double       lambda[PRB_DIM] );
 
-      // Eigenvalues / eigenvectors between points 1 (left) and 2 (right) for x-direction flux F
+      // Eigenvalues / eigenvectors between points 1 (left) and 2 (right) for x-direction flux F;
+      // the planar version leaves out the Alfven waves, the hydrodynamic one is that of the
+      // Euler equations (see getEigensHydroF)
+      template<EnoSystem S = EnoSystem::MHD>
       t_status getEigensF( double U1[PRB_DIM]
                          , double U2[PRB_DIM]
                          , double lambda[PRB_DIM]
                          , double lv[PRB_DIM][PRB_DIM]
                          , double rv[PRB_DIM][PRB_DIM] );
+      // Same, with lv and rv pointing into the eigensystem cache of the thread, where they stay
+      // valid until its next call; slot is the row j of an F face, nyTotal+j of a G face.
+      // Without the cache, they are computed into the slot anyway. Errors and warnings are not
+      // cached
+      template<EnoSystem S = EnoSystem::MHD>
+      t_status getEigensFCached( size_t   thread
+                               , size_t   slot
+                               , double   U1[PRB_DIM]
+                               , double   U2[PRB_DIM]
+                               , double   lambda[PRB_DIM]
+                               , double (*&lv)[PRB_DIM]
+                               , double (*&rv)[PRB_DIM] );
       // Eigenvalues / eigenvectors between points 1 (up) and 2 (down) for y-direction flux G
+      template<EnoSystem S = EnoSystem::MHD>
       t_status getEigensG( double U1[PRB_DIM]
                          , double U2[PRB_DIM]
                          , double lambda[PRB_DIM]
                          , double lv[PRB_DIM][PRB_DIM]
                          , double rv[PRB_DIM][PRB_DIM] );
 
+      // Closed-form eigensystem of the Euler equations (with passive v and w) between points
+      // 1 (left) and 2 (right), for B = 0; set for the system variables of EnoSystem::Hydro
+      t_status getEigensHydroF( double U1[PRB_DIM]
+                              , double U2[PRB_DIM]
+                              , double lambda[PRB_DIM]
+                              , double lv[PRB_DIM][PRB_DIM]
+                              , double rv[PRB_DIM][PRB_DIM] );
+
    private:
       static const size_t minimumBufferWidth = 2;
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<size_t R>
+double SpatialMethodEno::enoReconstruct
+   ( const double v[]
+   , const double dv[]
+   , size_t       i
+   , size_t       first
+){
+   // grow the stencil [s,s+m) from the first point; first by the differences of order 1
+   auto s = first;
+   if( ABS(dv[s-1]) < ABS(dv[s]) )
+      s--;
+   // then by those of higher orders m, V[m][l] of the points l to l+m (from l = i+1-R)
+   if( R > 2 ){
+      double V[R][enoStencilSize];
+      for( auto l = size_t{0}; l < 2*R-1; l++ )
+         V[1][l] = dv[i+1-R+l];
+      for( auto m = size_t{2}; m < R; m++ ){
+         for( auto l = size_t{0}; l < 2*R-m; l++ )
+            V[m][l] = V[m-1][l+1] - V[m-1][l];
+         if( ABS(V[m][s-1-(i+1-R)]) < ABS(V[m][s-(i+1-R)]) )
+            s--;
+      }
+   }
+
+   // value at the face from the stencil starting at i-r
+   const auto &c = t_enoStencil<R>::c[i+1-s];
+   auto value = c[0]*v[s];
+   for( auto m = size_t{1}; m < R; m++ )
+      value += c[m]*v[s+m];
+
+   return value;
+}
+
 #endif // SPATIALMETHODCENTRALFD_HPP
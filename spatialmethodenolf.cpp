@@ -1,7 +1,40 @@
 #include "spatialmethodenolf.hpp"
 
+#include <cstring>
 #include <stdexcept>
 
+namespace {
+   // Fifth order WENO reconstruction (Jiang and Shu) at the face between v2 and v3, from the
+   // values v0 to v4 of the upwind side; see eqs. (2.54)-(2.58) in C.-W. Shu, "Essentially
+   // Non-Oscillatory and Weighted Essentially Non-Oscillatory Schemes for Hyperbolic
+   // Conservation Laws", Lecture Notes in Mathematics 1697, pp.325-432, 1998
+   inline double weno5( double v0
+                      , double v1
+                      , double v2
+                      , double v3
+                      , double v4 )
+   {
+      const auto eps = 1e-6;
+
+      // candidate values of the three stencils
+      auto q0 = (1.0/3.0)*v0 - (7.0/6.0)*v1 + (11.0/6.0)*v2;
+      auto q1 = -(1.0/6.0)*v1 + (5.0/6.0)*v2 + (1.0/3.0)*v3;
+      auto q2 = (1.0/3.0)*v2 + (5.0/6.0)*v3 - (1.0/6.0)*v4;
+
+      // smoothness indicators
+      auto b0 = (13.0/12.0)*(v0 - 2.0*v1 + v2)*(v0 - 2.0*v1 + v2) + 0.25*(v0 - 4.0*v1 + 3.0*v2)*(v0 - 4.0*v1 + 3.0*v2);
+      auto b1 = (13.0/12.0)*(v1 - 2.0*v2 + v3)*(v1 - 2.0*v2 + v3) + 0.25*(v1 - v3)*(v1 - v3);
+      auto b2 = (13.0/12.0)*(v2 - 2.0*v3 + v4)*(v2 - 2.0*v3 + v4) + 0.25*(3.0*v2 - 4.0*v3 + v4)*(3.0*v2 - 4.0*v3 + v4);
+
+      // nonlinear weights from the linear weights 1/10, 6/10, 3/10
+      auto a0 = 0.1/( (eps + b0)*(eps + b0) );
+      auto a1 = 0.6/( (eps + b1)*(eps + b1) );
+      auto a2 = 0.3/( (eps + b2)*(eps + b2) );
+
+      return ( a0*q0 + a1*q1 + a2*q2 )/( a0 + a1 + a2 );
+   }
+}
+
 SpatialMethodEnoLF::SpatialMethodEnoLF
    ( size_t       nx
    , size_t       ny
@@ -10,13 +43,31 @@ SpatialMethodEnoLF::SpatialMethodEnoLF
    , double       dy
    , t_boundary   boundary
    , double       gamma
+   , EnoSystem    system
+   , EnoLFSplitting splitting
+   , double       hybridThreshold
+   , EnoLFReconstruction reconstruction
+   , size_t       order
+   , EnoLFViscosity viscosity
 )
-   : SpatialMethodEno{ nx, ny, bufferWidth, dx, dy, boundary, gamma }
+   : SpatialMethodEno{ nx, ny, bufferWidth, dx, dy, boundary, gamma, system }
+   , splitting{ splitting }
+   , hybridThreshold{ hybridThreshold }
+   , viscosity{ viscosity }
+   , order{ reconstruction == EnoLFReconstruction::WENO5 ? size_t{5} : order }
 {
-   alphaF = createVectors( PRB_DIM, nyTotal );
-   alphaG = createVectors( PRB_DIM, nxTotal );
-   F_  = createMatrices( PRB_DIM, nxTotal, nyTotal );
-   G_  = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   if( reconstruction == EnoLFReconstruction::ENO && ( order < 2 || order > enoMaxOrder ) ){
+      throw std::domain_error( "ENO order must be 2 to 4" );
+   }
+   if( bufferWidth < requiredBufferWidth( reconstruction, order ) ){
+      throw std::domain_error( "Buffer is too small for the reconstruction;"
+                               " need at least " + std::to_string( requiredBufferWidth( reconstruction, order ) ) + " extra grids" );
+   }
+
+   alphaF = createVectors( systemSize, nyTotal );
+   alphaG = createVectors( systemSize, nxTotal );
+   F_  = createMatrices( systemSize, nxTotal, nyTotal );
+   G_  = createMatrices( systemSize, nxTotal, nyTotal );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -29,6 +80,25 @@ SpatialMethodEnoLF::~SpatialMethodEnoLF
    freeMatrices( G_ );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodEnoLF::distributeMemory
+   (
+){
+   SpatialMethodEno::distributeMemory();
+   scheduler->distribute( F_, systemSize, nxTotal, nyTotal );
+   scheduler->distribute( G_, systemSize, nxTotal, nyTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t SpatialMethodEnoLF::requiredBufferWidth
+   ( EnoLFReconstruction reconstruction
+   , size_t              order
+){
+   if( reconstruction == EnoLFReconstruction::WENO5 )
+      return 3;
+   return std::max( order, SpatialMethodEno::requiredBufferWidth() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 t_status SpatialMethodEnoLF::integrate
    ( t_matrices      U
@@ -36,333 +106,782 @@ t_status SpatialMethodEnoLF::integrate
    , borderVectors   /*borderFlux*/
    , double         &dtIdeal
 ){
-   // for processing function return values
-   auto status = t_status{};
+   switch( enoSystem ){
+      case EnoSystem::Planar:
+         return integrateState<EnoSystem::Planar>( nullptr, U, UL, dtIdeal );
+      case EnoSystem::Hydro:
+         return integrateState<EnoSystem::Hydro>( nullptr, U, UL, dtIdeal );
+      default:
+         return integrateState<EnoSystem::MHD>( nullptr, U, UL, dtIdeal );
+   }
+}
 
-   // track maximum wave speeds (i.e., eigenvalues)
-   auto maxWaveSpeedX = double{0.0};
-   auto maxWaveSpeedY = double{0.0};
-
-   // temporary storage for function calls
-   const auto TN      = size_t{8};
-   const auto TNFIRST = size_t{2};
-   //const int TNLAST  = 6;
-   double tU1[PRB_DIM], tU2[PRB_DIM], tU[PRB_DIM][TN];
-   double tF[PRB_DIM][TN], tF_[PRB_DIM];
-   double tc[PRB_DIM], tLU[PRB_DIM];
-   double talpha[PRB_DIM];
-   auto tMaxWaveSpeed = double{};
-
-   // first, boundary conditions
-   status = applyBoundaryConditions( U );
-   if( status.isError ){
-      status.message += "\n! SpatialMethodEnoLF::integrate";
-      return status;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialMethodEnoLF::integrateStage
+   ( const t_stageUpdate  &stage
+   , t_matrices            U
+   , t_matrices            UL
+   , borderVectors         /*borderFlux*/
+   , double               &dtIdeal
+){
+   switch( enoSystem ){
+      case EnoSystem::Planar:
+         return integrateState<EnoSystem::Planar>( &stage, U, UL, dtIdeal );
+      case EnoSystem::Hydro:
+         return integrateState<EnoSystem::Hydro>( &stage, U, UL, dtIdeal );
+      default:
+         return integrateState<EnoSystem::MHD>( &stage, U, UL, dtIdeal );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialMethodEnoLF::getFluxY
+   ( size_t     j
+   , t_vectors  flux
+){
+   switch( enoSystem ){
+      case EnoSystem::Planar:
+         getSystemFluxY<EnoSystem::Planar>( j, flux );
+         break;
+      case EnoSystem::Hydro:
+         getSystemFluxY<EnoSystem::Hydro>( j, flux );
+         break;
+      default:
+         getSystemFluxY<EnoSystem::MHD>( j, flux );
+         break;
    }
 
-   // data is ready, calculate fluxes
-   updateFluxes( U );
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialMethodEnoLF::setSkipUniform
+   ( bool skip
+){
+   skipUniform = skip;
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodEnoLF::printStatistics
+   ( std::ostream &out
+) const {
+   if( skipUniform && fluxesTotal > 0 ){
+      out << " - Uniform regions    : " << 100.0*fluxesSkipped/fluxesTotal
+          << "% of the numerical fluxes copied instead of computed\n";
+   }
+   if( splitting == EnoLFSplitting::Hybrid && facesComputed > 0 ){
+      out << " - Hybrid splitting   : " << 100.0*facesCharacteristic/facesComputed
+          << "% of the computed fluxes characteristic (" << 100.0*fractionMin << "% to "
+          << 100.0*fractionMax << "% per integration)\n";
+   }
+   SpatialMethodEno::printStatistics( out );
+}
 
-   // find the viscosity coefficients required for LF flux splitting
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialMethodEnoLF::isDiscontinuity
+   ( const t_matrices  U
+   , size_t            i
+   , size_t            j
+   , size_t            di
+   , size_t            dj
+) const {
+   double r[4], p[4], b[4][3], bp[4];
+   for( auto l = size_t{0}; l < 4; l++ ){
+      auto ii = i+l*di-di;
+      auto jj = j+l*dj-dj;
+      r[l] = U[0][ii][jj];
+      if( r[l] <= 0.0 ) return true;   // (reported by the characteristic flux)
+      auto mm = U[1][ii][jj]*U[1][ii][jj] + U[2][ii][jj]*U[2][ii][jj] + U[3][ii][jj]*U[3][ii][jj];
+      auto bb = U[4][ii][jj]*U[4][ii][jj] + U[5][ii][jj]*U[5][ii][jj] + U[6][ii][jj]*U[6][ii][jj];
+      p[l] = std::max( (gamma-1.0)*( U[7][ii][jj] - 0.5*mm/r[l] - 0.5*bb ), 0.0 );
+      for( auto c = size_t{0}; c < 3; c++ )
+         b[l][c] = U[4+c][ii][jj];
+      bp[l] = sqrt(bb) + sqrt(2.0*p[l]);
+   }
+
+   auto exceeds = [this]( double qm, double q, double qp, double sum ){
+      return fabs( qp - 2.0*q + qm ) > hybridThreshold*sum;
+   };
+   for( auto l = size_t{1}; l <= 2; l++ ){
+      if( exceeds( r[l-1], r[l], r[l+1], r[l-1] + 2.0*r[l] + r[l+1] ) ) return true;
+      if( exceeds( p[l-1], p[l], p[l+1], p[l-1] + 2.0*p[l] + p[l+1] ) ) return true;
+      for( auto c = size_t{0}; c < 3; c++ ){
+         if( exceeds( b[l-1][c], b[l][c], b[l+1][c], bp[l-1] + 2.0*bp[l] + bp[l+1] ) ) return true;
+      }
+   }
+
+   return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialMethodEnoLF::isCharacteristic
+   ( const t_matrices  U
+   , size_t            i
+   , size_t            j
+   , size_t            di
+   , size_t            dj
+) const {
+   switch( splitting ){
+      case EnoLFSplitting::Hybrid:
+         return isDiscontinuity( U, i, j, di, dj );
+      case EnoLFSplitting::Componentwise:
+         return false;
+      default:
+         return true;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<size_t H>
+bool SpatialMethodEnoLF::isUniformStencil
+   ( const t_matrices  U
+   , size_t            i
+   , size_t            j
+   , size_t            di
+   , size_t            dj
+) const {
+   for( auto l = size_t{0}; l < 2*H; l++ ){
+      if( !isSamePoint( U, i+(l-H)*di, j+(l-H)*dj, i+(l+1-H)*di, j+(l+1-H)*dj ) )
+         return false;
+   }
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialMethodEnoLF::isSamePoint
+   ( const t_matrices  U
+   , size_t            i1
+   , size_t            j1
+   , size_t            i2
+   , size_t            j2
+){
+   // compare bits rather than values, so that 0.0 and -0.0 count as different
    for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      for( auto i = nxFirst-1; i < nxLast; i++ )
-         alphaG[k][i] = 0.0;
-      for( auto j = nyFirst-1; j < nyLast; j++ )
-         alphaF[k][j] = 0.0;
+      if( std::memcmp( &U[k][i1][j1], &U[k][i2][j2], sizeof(double) ) != 0 )
+         return false;
    }
 
-   for( auto i = nxFirst-1; i < nxLast; i++ ){
-      for( auto j = nyFirst-1; j < nyLast; j++ ){
-         // skip corner
-         if( i < nxFirst && j < nxFirst ) continue;
+   return true;
+}
 
-         // flux F - prepare data
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            tU1[k] = U[k][i][j];
-         }
-         // get localized eigenvalues
-         status = getEigenvaluesAt( tU1, talpha );
-         if( status.status != ReturnStatus::OK ){
-            status.message += std::string{}
-                           + "\n! SpatialMethodEnoLF::integrate: F eigenvalues "
-                           + "( i = " + std::to_string( int(i)-int(nxFirst) )
-                           + ", j = " + std::to_string( int(j)-int(nyFirst) ) + " )";
-         }
-         if( status.isError ){
-            return status;
-         }
-         // update per-y maximums
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            auto alphaabs = fabs(talpha[k]);
-            if( alphaabs > alphaF[k][j] )
-               alphaF[k][j] = alphaabs;
-         }
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
+void SpatialMethodEnoLF::getSystemFluxY
+   ( size_t     j
+   , t_vectors  flux
+){
+   typedef t_enoSystem<S> System;
+
+   for( auto k = System::size; k < PRB_DIM; k++ )
+      for( auto i = nxFirst; i < nxLast; i++ )
+         flux[System::missing( k-System::size )][i] = 0.0;
+   for( auto k = size_t{0}; k < System::size; k++ )
+      for( auto i = nxFirst; i < nxLast; i++ )
+         flux[System::var( k )][i] = G_[k][i][j];
+}
 
-         // flux G - prepare data
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            tU1[k] = U[k][i][j];
-         }
-         std::swap( tU1[1], tU1[2] ); std::swap( tU1[4], tU1[5] );
-
-         // get localized eigenvalues
-         status = getEigenvaluesAt( tU1, talpha );
-         if( status.status != ReturnStatus::OK ){
-            status.message += std::string{}
-                           + "\n! SpatialMethodEnoLF::integrate: G eigenvalues "
-                           + "( i = " + std::to_string( int(i)-int(nxFirst) )
-                           + ", j = " + std::to_string( int(j)-int(nyFirst) ) + " )";
-         }
-         if( status.isError ){
-            return status;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S>
+t_status SpatialMethodEnoLF::integrateState
+   ( const t_stageUpdate  *stage
+   , t_matrices            U
+   , t_matrices            UL
+   , double               &dtIdeal
+){
+   switch( order ){
+      case 3:
+         return integrateStencil<S, 3>( stage, U, UL, dtIdeal );
+      case 4:
+         return integrateStencil<S, 4>( stage, U, UL, dtIdeal );
+      case 5:
+         return integrateStencil<S, 5>( stage, U, UL, dtIdeal );
+      default:
+         return integrateStencil<S, 2>( stage, U, UL, dtIdeal );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S, size_t R>
+t_status SpatialMethodEnoLF::integrateStencil
+   ( const t_stageUpdate  *stage
+   , t_matrices            U
+   , t_matrices            UL
+   , double               &dtIdeal
+){
+   typedef t_enoSystem<S> System;
+
+   // for processing function return values
+   auto status = t_status{};
+
+   // temporary storage for function calls, and the points of the stencil on either side of a face
+   const auto TN      = enoStencilSize;
+   const auto H       = stencilHalfWidth( R );
+
+   // results of the individual phases
+   TileResults boundaryResults{ scheduler->getThreadCount() };
+   TileResults alphaResults{ scheduler->getThreadCount() };
+   TileResults fluxResultsF{ scheduler->getThreadCount() };
+   TileResults fluxResultsG{ scheduler->getThreadCount() };
+   auto failed = [&](){
+      return boundaryResults.failed() || alphaResults.failed() || fluxResultsF.failed() || fluxResultsG.failed();
+   };
+   // numerical fluxes copied from the previous face, computed, and computed in the
+   // characteristic fields, per thread
+   std::vector<size_t> skipped( scheduler->getThreadCount(), 0 );
+   std::vector<size_t> computed( scheduler->getThreadCount(), 0 );
+   std::vector<size_t> characteristic( scheduler->getThreadCount(), 0 );
+
+   // phases of the integration step; F and G parts only depend on the boundaries and
+   // their own preceding phases, so they are processed at the same time
+   TileGraph graph;
+
+   // first, boundary conditions and physical fluxes
+   auto boundaries = std::vector<TileGraph::t_node>{};
+   auto fluxes     = std::vector<TileGraph::t_node>{};
+   addStateTasks<S>( graph, U, stage, boundaryResults, failed, boundaries, fluxes );
+
+   // find the viscosity coefficients required for LF flux splitting;
+   // per-row maximums for flux F, per-column maximums for flux G (local ones are found with
+   // the fluxes)
+   auto sweepFDependencies = fluxes;
+   auto sweepGDependencies = fluxes;
+   if( viscosity == EnoLFViscosity::Row ){
+      sweepFDependencies.push_back( graph.addTask( rowFirst-1, rowLast, [&]( size_t jFirst, size_t jLast, size_t thread ){
+         double tU1[PRB_DIM], talpha[PRB_DIM];
+         if( failed() ) return;
+
+         for( auto j = jFirst; j < jLast; j++ ){
+            for( auto k = size_t{0}; k < System::size; k++ )
+               alphaF[k][j] = 0.0;
+
+            for( auto i = nxFirst-1; i < nxLast; i++ ){
+               // skip corner
+               if( i < nxFirst && j < nxFirst ) continue;
+               // a point equal to the previous one has the same eigenvalues
+               if( skipUniform && i > nxFirst && isSamePoint( U, i, j, i-1, j ) ) continue;
+
+               // flux F - prepare data
+               for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+                  tU1[k] = U[k][i][j];
+               }
+               // get localized eigenvalues
+               auto pointStatus = getEigenvaluesAt( tU1, talpha );
+               if( pointStatus.status != ReturnStatus::OK ){
+                  pointStatus.message += std::string{}
+                                      + "\n! SpatialMethodEnoLF::integrate: F eigenvalues "
+                                      + "( i = " + std::to_string( int(i)-int(nxFirst) )
+                                      + ", j = " + std::to_string( int(j)-int(nyFirst) ) + " )";
+               }
+               if( pointStatus.isError ){
+                  alphaResults.setError( thread, i*nyTotal+j, pointStatus );
+                  return;
+               }
+               // update per-y maximums
+               for( auto k = size_t{0}; k < System::size; k++ ){
+                  auto alphaabs = fabs(talpha[System::wave( k )]);
+                  if( alphaabs > alphaF[k][j] )
+                     alphaF[k][j] = alphaabs;
+               }
+            }
          }
-         // update per-x maximums
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            auto alphaabs = fabs(talpha[k]);
-            if( alphaabs > alphaG[k][i] )
-               alphaG[k][i] = alphaabs;
+      }, boundaries ) );
+
+      sweepGDependencies.push_back( graph.addTask( nxFirst-1, nxLast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+         double tU1[PRB_DIM], talpha[PRB_DIM];
+         if( oneDimensional || failed() ) return;
+
+         for( auto i = iFirst; i < iLast; i++ ){
+            for( auto k = size_t{0}; k < System::size; k++ )
+               alphaG[k][i] = 0.0;
+
+            for( auto j = rowFirst-1; j < rowLast; j++ ){
+               // skip corner
+               if( i < nxFirst && j < nxFirst ) continue;
+               if( skipUniform && j > rowFirst && isSamePoint( U, i, j, i, j-1 ) ) continue;
+
+               // flux G - prepare data
+               for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+                  tU1[k] = U[k][i][j];
+               }
+               std::swap( tU1[1], tU1[2] ); std::swap( tU1[4], tU1[5] );
+
+               // get localized eigenvalues
+               auto pointStatus = getEigenvaluesAt( tU1, talpha );
+               if( pointStatus.status != ReturnStatus::OK ){
+                  pointStatus.message += std::string{}
+                                      + "\n! SpatialMethodEnoLF::integrate: G eigenvalues "
+                                      + "( i = " + std::to_string( int(i)-int(nxFirst) )
+                                      + ", j = " + std::to_string( int(j)-int(nyFirst) ) + " )";
+               }
+               if( pointStatus.isError ){
+                  alphaResults.setError( thread, i*nyTotal+j, pointStatus );
+                  return;
+               }
+               // update per-x maximums
+               for( auto k = size_t{0}; k < System::size; k++ ){
+                  auto alphaabs = fabs(talpha[System::wave( k )]);
+                  if( alphaabs > alphaG[k][i] )
+                     alphaG[k][i] = alphaabs;
+               }
+            }
          }
-      }
+      }, boundaries ) );
    }
 
    /******************************
     *           F flux           *
     ******************************/
-   for( auto i = nxFirst-1; i < nxLast; i++ ){
-      for( auto j = nyFirst; j < nyLast; j++ ){
-         // prepare data
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            if( boundary.left == BoundaryCondition::Open && i < nxFirst ){
-               tU1[k] = U[k][i+1][j];       // left point
-            } else {
-               tU1[k] = U[k][i][j];         // left point
+   auto sweepF = graph.addTask( nxFirst-1, nxLast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+      double tU1[PRB_DIM], tU2[PRB_DIM], tU[System::size][TN];
+      double tF[System::size][TN], tF_[System::size];
+      double tc[PRB_DIM], tLU[PRB_DIM];
+      double talpha[System::size];
+      auto tMaxWaveSpeed = double{};
+
+      for( auto i = iFirst; i < iLast; i++ ){
+         // the stencil of face i+1/2 (points i+1-H to i+H) equals that of face i-1/2 if the
+         // points i-H to i+H are equal; the face i-1/2 has to be computed by
+         // this task, and neither face may be changed by an open boundary
+         auto canSkip = skipUniform && i > std::max( iFirst, nxFirst ) && i+H <= nxLast
+                     && faceScaleX( i ) == faceScaleX( i-1 );
+         for( auto j = rowFirst; j < rowLast; j++ ){
+            if( failed() ) return;
+
+            if( canSkip && isUniformStencil<H>( U, i, j, 1, 0 ) ){
+               for( auto k = size_t{0}; k < System::size; k++ ){
+                  F_[k][i][j]    = F_[k][i-1][j];
+                  _cx[System::wave( k )][i][j]   = _cx[System::wave( k )][i-1][j];
+                  _LUx[System::wave( k )][i][j]  = _LUx[System::wave( k )][i-1][j];
+               }
+               skipped[thread]++;
+               continue;
+            }
+
+            // prepare data
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               if( boundary.left == BoundaryCondition::Open && i < nxFirst ){
+                  tU1[k] = U[k][i+1][j];       // left point
+               } else {
+                  tU1[k] = U[k][i][j];         // left point
+               }
+               if( boundary.right == BoundaryCondition::Open && i > nxLast-2 ){
+                  tU2[k] = U[k][i][j];         // right point
+               } else {
+                  tU2[k] = U[k][i+1][j];       // right point
+               }
             }
-            if( boundary.right == BoundaryCondition::Open && i > nxLast-2 ){
-               tU2[k] = U[k][i][j];         // right point
-            } else {
-               tU2[k] = U[k][i+1][j];       // right point
+            for( auto k = size_t{0}; k < System::size; k++ ){
+               for( auto l = enoFaceIndex+1-H; l <= enoFaceIndex+H; l++ ){
+                  tU[k][l] = U[System::var( k )][i+l-enoFaceIndex][j]; // point
+                  tF[k][l] = F[k][i+l-enoFaceIndex][j];                // physical flux
+               }
             }
-            for( auto l = size_t{0}; l < 4; l++ ){
-               tU[k][TNFIRST+l] = U[k][i-1+l][j]; // point
-               tF[k][TNFIRST+l] = F[k][i-1+l][j]; // physical flux
+            if( viscosity == EnoLFViscosity::Row ){
+               for( auto k = size_t{0}; k < System::size; k++ )
+                  talpha[k] = alphaF[k][j];
             }
-            talpha[k] = alphaF[k][j];
-         }
 
-         // find numerical flux
-         status = getNumericalFluxF( tU1, tU2, tU, tF, talpha, tF_, tc, tLU, tMaxWaveSpeed );
-         if( status.isError ){
-            status.message += "\n! SpatialMethodEnoLF::integrate: F flux";
-            return status;
-         }
+            // find numerical flux
+            auto tCharacteristic = isCharacteristic( U, i, j, 1, 0 );
+            computed[thread]++;
+            if( tCharacteristic ) characteristic[thread]++;
+            auto pointStatus = getNumericalFluxF<S, R>( thread, j, tCharacteristic, tU1, tU2, tU, tF, talpha, tF_, tc, tLU, tMaxWaveSpeed );
+            if( pointStatus.isError ){
+               pointStatus.message += "\n! SpatialMethodEnoLF::integrate: F flux";
+               fluxResultsF.setError( thread, i*nyTotal+j, pointStatus );
+               return;
+            }
 
-         //process results
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            F_[k][i][j]    = tF_[k];
-            _cx[k][i][j]   = tc[k];
-            _LUx[k][i][j]  = tLU[k];
+            //process results
+            for( auto k = size_t{0}; k < System::size; k++ ){
+               F_[k][i][j]    = tF_[k];
+               _cx[System::wave( k )][i][j]   = tc[System::wave( k )];
+               _LUx[System::wave( k )][i][j]  = tLU[System::wave( k )];
+            }
+            fluxResultsF.updateMax( thread, tMaxWaveSpeed*faceScaleX( i ) );
          }
-         if( tMaxWaveSpeed > maxWaveSpeedX )
-            maxWaveSpeedX = tMaxWaveSpeed;
       }
-   }
+   }, sweepFDependencies );
 
    /******************************
     *           G flux           *
     ******************************/
-   for( auto i = nxFirst; i < nxLast; i++ ){
-      for( auto j = nyFirst-1; j < nyLast; j++ ){
-         // prepare data
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            if( boundary.bottom == BoundaryCondition::Open && j < nyFirst ){
-               tU1[k] = U[k][i][j+1];       // down point
-            } else {
-               tU1[k] = U[k][i][j];         // down point
+   auto sweepG = graph.addTask( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+      double tU1[PRB_DIM], tU2[PRB_DIM], tU[System::size][TN];
+      double tF[System::size][TN], tF_[System::size];
+      double tc[PRB_DIM], tLU[PRB_DIM];
+      double talpha[System::size];
+      auto tMaxWaveSpeed = double{};
+      if( oneDimensional ) return;
+
+      for( auto i = iFirst; i < iLast; i++ ){
+         for( auto j = rowFirst-1; j < rowLast; j++ ){
+            if( failed() ) return;
+
+            // same as for F, along the column
+            if( skipUniform && j > rowFirst && j+H <= nyLast && faceScaleY( j ) == faceScaleY( j-1 )
+                && isUniformStencil<H>( U, i, j, 0, 1 ) ){
+               for( auto k = size_t{0}; k < System::size; k++ ){
+                  G_[k][i][j]    = G_[k][i][j-1];
+                  _cy[System::wave( k )][i][j]   = _cy[System::wave( k )][i][j-1];
+                  _LUy[System::wave( k )][i][j]  = _LUy[System::wave( k )][i][j-1];
+               }
+               skipped[thread]++;
+               continue;
             }
-            if( boundary.top == BoundaryCondition::Open && j > nyLast-2 ){
-               tU2[k] = U[k][i][j];         // up point
-            } else {
-               tU2[k] = U[k][i][j+1];       // up point
+
+            // prepare data
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               if( boundary.bottom == BoundaryCondition::Open && !mirrorBottom && j < nyFirst ){
+                  tU1[k] = U[k][i][j+1];       // down point
+               } else {
+                  tU1[k] = U[k][i][j];         // down point
+               }
+               if( boundary.top == BoundaryCondition::Open && j > nyLast-2 ){
+                  tU2[k] = U[k][i][j];         // up point
+               } else {
+                  tU2[k] = U[k][i][j+1];       // up point
+               }
             }
-            for( auto l = size_t{0}; l < 4; l++ ){
-               tU[k][TNFIRST+l] = U[k][i][j-1+l]; // point
-               tF[k][TNFIRST+l] = G[k][i][j-1+l]; // physical flux
+            for( auto k = size_t{0}; k < System::size; k++ ){
+               for( auto l = enoFaceIndex+1-H; l <= enoFaceIndex+H; l++ ){
+                  tU[k][l] = U[System::var( k )][i][j+l-enoFaceIndex]; // point
+                  tF[k][l] = G[k][i][j+l-enoFaceIndex];                // physical flux
+               }
+            }
+            if( viscosity == EnoLFViscosity::Row ){
+               for( auto k = size_t{0}; k < System::size; k++ )
+                  talpha[k] = alphaG[k][i];
+            }
+
+            // find numerical flux
+            auto tCharacteristic = isCharacteristic( U, i, j, 0, 1 );
+            computed[thread]++;
+            if( tCharacteristic ) characteristic[thread]++;
+            auto pointStatus = getNumericalFluxG<S, R>( thread, nyTotal+j, tCharacteristic, tU1, tU2, tU, tF, talpha, tF_, tc, tLU, tMaxWaveSpeed );
+            if( pointStatus.isError ){
+               pointStatus.message += "\n! SpatialMethodEnoLF::integrate: G flux";
+               fluxResultsG.setError( thread, i*nyTotal+j, pointStatus );
+               return;
             }
-            talpha[k] = alphaG[k][i];
-         }
 
-         // find numerical flux
-         status = getNumericalFluxG( tU1, tU2, tU, tF, talpha, tF_, tc, tLU, tMaxWaveSpeed );
-         if( status.isError ){
-            status.message += "\n! SpatialMethodEnoLF::integrate: G flux";
-            return status;
+            //process results
+            for( auto k = size_t{0}; k < System::size; k++ ){
+               G_[k][i][j]    = tF_[k];
+               _cy[System::wave( k )][i][j]   = tc[System::wave( k )];
+               _LUy[System::wave( k )][i][j]  = tLU[System::wave( k )];
+            }
+            fluxResultsG.updateMax( thread, tMaxWaveSpeed*faceScaleY( j ) );
          }
+      }
+   }, sweepGDependencies );
 
-         //process results
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            G_[k][i][j]    = tF_[k];
-            _cy[k][i][j]   = tc[k];
-            _LUy[k][i][j]  = tLU[k];
+   // use numerical fluxes to calculate dU/dt
+   graph.addTask( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+      if( failed() ) return;
+      for( auto k = size_t{0}; k < System::size; k++ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            if( oneDimensional ){
+               for( auto j = rowFirst; j < rowLast; j++ ){
+                  UL[System::var( k )][i][j] = -dxInv[i]*( F_[k][i][j] - F_[k][i-1][j] );
+               }
+               continue;
+            }
+            for( auto j = rowFirst; j < rowLast; j++ ){
+               UL[System::var( k )][i][j] = -dxInv[i]*( F_[k][i][j] - F_[k][i-1][j] )
+                                            -dyInv[j]*( G_[k][i][j] - G_[k][i][j-1] );
+            }
          }
-         if( tMaxWaveSpeed > maxWaveSpeedY )
-            maxWaveSpeedY = tMaxWaveSpeed;
       }
+      for( auto k = System::size; k < PRB_DIM; k++ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            for( auto j = rowFirst; j < rowLast; j++ ){
+               UL[System::missing( k-System::size )][i][j] = 0.0;
+            }
+         }
+      }
+      if( alfvenLimitInv2 > 0.0 ){
+         applyAlfvenLimit( U, UL, iFirst, iLast );
+      }
+   }, { sweepF, sweepG } );
+
+   scheduler->run( graph );
+
+   // errors are reported in the order of the phases
+   if( boundaryResults.failed() ){
+      status = boundaryResults.getError();
+      status.message += "\n! SpatialMethodEnoLF::integrate";
+      return status;
+   }
+   if( alphaResults.failed() ){
+      return alphaResults.getError();
+   }
+   if( fluxResultsF.failed() ){
+      return fluxResultsF.getError();
+   }
+   if( fluxResultsG.failed() ){
+      return fluxResultsG.getError();
+   }
+
+   // faces of the F and G sweeps
+   fluxesTotal += ( nxLast-nxFirst+1 )*( rowLast-rowFirst );
+   if( !oneDimensional )
+      fluxesTotal += ( nxLast-nxFirst )*( rowLast-rowFirst+1 );
+   for( auto count : skipped )
+      fluxesSkipped += count;
+   auto computedTotal       = size_t{0};
+   auto characteristicTotal = size_t{0};
+   for( auto t = size_t{0}; t < computed.size(); t++ ){
+      computedTotal       += computed[t];
+      characteristicTotal += characteristic[t];
+   }
+   if( computedTotal > 0 ){
+      facesComputed       += computedTotal;
+      facesCharacteristic += characteristicTotal;
+      fractionMin = std::min( fractionMin, double(characteristicTotal)/computedTotal );
+      fractionMax = std::max( fractionMax, double(characteristicTotal)/computedTotal );
    }
 
+   // track maximum wave speeds (i.e., eigenvalues)
+   auto maxWaveSpeedX = fluxResultsF.getMax();
+   auto maxWaveSpeedY = fluxResultsG.getMax();
+
    #ifdef DEBUG_MAX_VELOCITY
       OUT << "*** DEBUG: maxWaveSpeedX = " << maxWaveSpeedX
           << ", maxWaveSpeedY = " << maxWaveSpeedY << "\n";
    #endif // DEBUG_MAX_VELOCITY
 
    // update local dt from max wave speeds
-   dtIdeal = std::min( dx/maxWaveSpeedX, dy/maxWaveSpeedY );
+   dtIdeal = oneDimensional ? dx/maxWaveSpeedX : std::min( dx/maxWaveSpeedX, dy/maxWaveSpeedY );
 
-   // use numerical fluxes to calculate dU/dt
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      for( auto i = nxFirst; i < nxLast; i++ ){
-         for( auto j = nyFirst; j < nyLast; j++ ){
-            UL[k][i][j] = -(1.0/dx)*( F_[k][i][j] - F_[k][i-1][j] )
-                          -(1.0/dy)*( G_[k][i][j] - G_[k][i][j-1] );
-         }
-      }
+   return status;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<size_t R>
+void SpatialMethodEnoLF::reconstructSplitting
+   ( size_t  N
+   , double  RU[PRB_DIM][enoStencilSize]
+   , double  RF[PRB_DIM][enoStencilSize]
+   , double  alpha[PRB_DIM]
+   , double  wm[PRB_DIM]
+   , double  wp[PRB_DIM]
+){
+   const auto i = enoFaceIndex;
+   // split flux and its undivided differences
+   double w[enoStencilSize], Vw[enoStencilSize];
+
+   for( auto k = size_t{0}; k < N; k++ ){
+      // positive part of the flux splitting, upwind from the left: flux on the minus edge
+      for( auto l = i+1-R; l <= i+R; l++ )
+         w[l] = 0.5*( RF[k][l] + alpha[k]*RU[k][l] );
+      for( auto l = i+1-R; l < i+R; l++ )
+         Vw[l] = w[l+1] - w[l];
+      wm[k] = enoReconstruct<R>( w, Vw, i, i );
+
+      // negative part, upwind from the right: flux on the plus edge
+      for( auto l = i+1-R; l <= i+R; l++ )
+         w[l] = 0.5*( RF[k][l] - alpha[k]*RU[k][l] );
+      for( auto l = i+1-R; l < i+R; l++ )
+         Vw[l] = w[l+1] - w[l];
+      wp[k] = enoReconstruct<R>( w, Vw, i, i+1 );
    }
+}
 
-   return status;
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<>
+void SpatialMethodEnoLF::reconstructSplitting<5>
+   ( size_t  N
+   , double  RU[PRB_DIM][enoStencilSize]
+   , double  RF[PRB_DIM][enoStencilSize]
+   , double  alpha[PRB_DIM]
+   , double  wm[PRB_DIM]
+   , double  wp[PRB_DIM]
+){
+   const auto i = enoFaceIndex;
+   // split flux
+   double w[enoStencilSize];
+
+   for( auto k = size_t{0}; k < N; k++ ){
+      // positive part of the flux splitting, from the left (points -2 to +2), and negative
+      // part, from the right (points +3 to -1)
+      for( auto l = i-2; l <= i+3; l++ )
+         w[l] = 0.5*( RF[k][l] + alpha[k]*RU[k][l] );
+      wm[k] = weno5( w[i-2], w[i-1], w[i], w[i+1], w[i+2] );
+      for( auto l = i-2; l <= i+3; l++ )
+         w[l] = 0.5*( RF[k][l] - alpha[k]*RU[k][l] );
+      wp[k] = weno5( w[i+3], w[i+2], w[i+1], w[i], w[i-1] );
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S, size_t R>
 t_status SpatialMethodEnoLF::getNumericalFluxF
-   ( double    U1[PRB_DIM]
+   ( size_t    thread
+   , size_t    slot
+   , bool      characteristic
+   , double    U1[PRB_DIM]
    , double    U2[PRB_DIM]
-   , double    U[PRB_DIM][8]
-   , double    F[PRB_DIM][8]
+   , double    U[PRB_DIM][enoStencilSize]
+   , double    F[PRB_DIM][enoStencilSize]
    , double    alpha[PRB_DIM]
    , double    F_[PRB_DIM]
    , double    cx[PRB_DIM]
    , double    LUx[PRB_DIM]
    , double   &maxWaveSpeed
 ){
-   const auto TNFIRST = size_t{2};
-   // current index
-   const auto i = TNFIRST+1;
+   typedef t_enoSystem<S> System;
+   const auto N = System::size;
+
+   // current index, and the points of the stencil on either side of the face
+   const auto i = enoFaceIndex;
+   const auto H = stencilHalfWidth( R );
 
    // eigenvalues & eigenvectors @ u_(i+1/2)
    auto a = cx;
-   double lv[PRB_DIM][PRB_DIM], rv[PRB_DIM][PRB_DIM];
-   // characteristics and differences
-   double RU[PRB_DIM][8], RF[PRB_DIM][8];
-   double w[PRB_DIM][8], Vw[PRB_DIM][7];
+   double (*lv)[PRB_DIM], (*rv)[PRB_DIM];
+   // characteristics
+   double RU[PRB_DIM][enoStencilSize], RF[PRB_DIM][enoStencilSize];
    // fluxes on minus edge, plus edge, and final
    double wm[PRB_DIM], wp[PRB_DIM], fw[PRB_DIM];
+   // eigenvectors of the characteristic fields, restricted to the system variables, and the
+   // viscosity coefficients of the splitting
+   double lvs[N][N], rvs[N][N], alphaUsed[N];
+   auto status = t_status{ false, ReturnStatus::OK, std::string{} };
 
    // maximum wave speed (ie, eigenvalue)
    maxWaveSpeed = 0.0;
 
-   // eigensystem
-   auto status = getEigensF( U1, U2, a, lv, rv );
-   if( status.status != ReturnStatus::OK ){
-      status.message += "\n! SpatialMethodEnoLF::getNumericalFluxF";
-   }
-   if( status.isError )
-      return status;
+   // local viscosity coefficients are the eigenvalues of the face
+   auto local = viscosity == EnoLFViscosity::Local;
 
-   // update maximum wave speed
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      auto aabs = fabs(a[k]);
-      if( aabs > maxWaveSpeed )
-         maxWaveSpeed = aabs;
-   }
+   // per variable, the splitting uses the largest alpha for all variables, and only needs
+   // the eigenvalues
+   if( !characteristic ){
+      status = getEigenvaluesBetween( U1, U2, a );
+      if( status.status != ReturnStatus::OK ){
+         status.message += "\n! SpatialMethodEnoLF::getNumericalFluxF";
+      }
+      if( status.isError )
+         return status;
 
-   // local characteristics and undivided differences
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      for( auto l = i-1; l <= i+2; l++ ){
-         RU[k][l] = 0.0;
-         RF[k][l] = 0.0;
-         for( auto m = size_t{0}; m < PRB_DIM; m++ ){
-            RU[k][l] += lv[k][m]*U[m][l];
-            RF[k][l] += lv[k][m]*F[m][l];
+      auto alphaMax = 0.0;
+      for( auto k = size_t{0}; k < N; k++ ){
+         maxWaveSpeed = std::max( maxWaveSpeed, fabs(a[System::wave( k )]) );
+         alphaMax = std::max( alphaMax, local ? fabs(a[System::wave( k )]) : alpha[k] );
+      }
+      for( auto k = size_t{0}; k < N; k++ ){
+         for( auto l = i+1-H; l <= i+H; l++ ){
+            RU[k][l] = U[k][l];
+            RF[k][l] = F[k][l];
          }
+         alphaUsed[k] = alphaMax;
+      }
+   } else {
+      status = getEigensFCached<S>( thread, slot, U1, U2, a, lv, rv );
+      if( status.status != ReturnStatus::OK ){
+         status.message += "\n! SpatialMethodEnoLF::getNumericalFluxF";
+      }
+      if( status.isError )
+         return status;
+
+      // update maximum wave speed
+      for( auto k = size_t{0}; k < N; k++ ){
+         auto aabs = fabs(a[System::wave( k )]);
+         if( aabs > maxWaveSpeed )
+            maxWaveSpeed = aabs;
       }
-   }
 
-   // positive part of the flux splitting
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      for( auto l = i-1; l <= i+2; l++ )
-         w[k][l] = 0.5*( RF[k][l] + alpha[k]*RU[k][l] );
-      for( auto l = i-1; l <= i+1; l++ )
-         Vw[k][l] = w[k][l+1] - w[k][l];
-   }
-   // flux on the minus edge
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      if( ABS(Vw[k][i-1]) < ABS(Vw[k][i]) ) // left (stencil -3/2, -1/2, +1/2)
-         wm[k] = -(1.0/2.0)*w[k][i-1] + (3.0/2.0)*w[k][i];
-      else // right (stencil -1/2, +1/2, +3/2)
-         wm[k] = (1.0/2.0)*w[k][i] + (1.0/2.0)*w[k][i+1];
-   }
+      // eigenvectors of the characteristic fields, restricted to the system variables
+      for( auto k = size_t{0}; k < N; k++ ){
+         for( auto m = size_t{0}; m < N; m++ ){
+            lvs[k][m] = lv[System::wave( k )][System::var( m )];
+            rvs[k][m] = rv[System::wave( k )][System::var( m )];
+         }
+      }
 
-   // negative part of the flux splitting
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      for( auto l = i-1; l <= i+2; l++ )
-         w[k][l] = 0.5*( RF[k][l] - alpha[k]*RU[k][l] );
-      for( auto l = i-1; l <= i+1; l++ )
-         Vw[k][l] = w[k][l+1] - w[k][l];
-   }
-   // flux on the plus edge
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      if( ABS(Vw[k][i]) < ABS(Vw[k][i+1]) ) // left (stencil -3/2, -1/2, +1/2)
-         wp[k] = (1.0/2.0)*w[k][i] + (1.0/2.0)*w[k][i+1];
-      else // right (stencil -1/2, +1/2, +3/2)
-         wp[k] = (3.0/2.0)*w[k][i+1] - (1.0/2.0)*w[k][i+2];
+      // local characteristics and undivided differences
+      for( auto k = size_t{0}; k < N; k++ ){
+         for( auto l = i+1-H; l <= i+H; l++ ){
+            RU[k][l] = 0.0;
+            RF[k][l] = 0.0;
+            for( auto m = size_t{0}; m < N; m++ ){
+               RU[k][l] += lvs[k][m]*U[m][l];
+               RF[k][l] += lvs[k][m]*F[m][l];
+            }
+         }
+         alphaUsed[k] = local ? fabs(a[System::wave( k )]) : alpha[k];
+      }
    }
 
+   // flux on the minus and plus edge
+   reconstructSplitting<R>( N, RU, RF, alphaUsed, wm, wp );
+
    // total numerical flux
    // TODO: treat open boundary conditions
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+   for( auto k = size_t{0}; k < N; k++ ){
       fw[k] = wm[k] + wp[k];
    }
 
    // return to physical space fluxes
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+   if( !characteristic ){
+      for( auto k = size_t{0}; k < N; k++ ){
+         F_[k] = fw[k];
+         LUx[System::wave( k )] = 0.0;
+      }
+      return status;
+   }
+   for( auto k = size_t{0}; k < N; k++ ){
       F_[k] = 0.0;
-      for( auto l = size_t{0}; l < PRB_DIM; l++ )
-         F_[k] += rv[l][k]*fw[l];
+      for( auto l = size_t{0}; l < N; l++ )
+         F_[k] += rvs[l][k]*fw[l];
    }
 
    // Characteristic variables
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      LUx[k] = RU[k][i];
+   for( auto k = size_t{0}; k < N; k++ ){
+      LUx[System::wave( k )] = RU[k][i];
    }
 
    return status;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<EnoSystem S, size_t R>
 t_status SpatialMethodEnoLF::getNumericalFluxG
-   ( double    U1[PRB_DIM]
+   ( size_t    thread
+   , size_t    slot
+   , bool      characteristic
+   , double    U1[PRB_DIM]
    , double    U2[PRB_DIM]
-   , double    U[PRB_DIM][8]
-   , double    G[PRB_DIM][8]
+   , double    U[PRB_DIM][enoStencilSize]
+   , double    G[PRB_DIM][enoStencilSize]
    , double    alpha[PRB_DIM]
    , double    G_[PRB_DIM]
    , double    cy[PRB_DIM]
    , double    LUy[PRB_DIM]
    , double   &maxWaveSpeed
 ){
+   typedef t_enoSystem<S> System;
+
    // invert x and y axis
    std::swap( U1[1], U1[2] ); std::swap( U1[4], U1[5] );
    std::swap( U2[1], U2[2] ); std::swap( U2[4], U2[5] );
-   for( auto i = size_t{0}; i < 8; i++ ){
-      std::swap( U[1][i], U[2][i] ); std::swap( U[4][i], U[5][i] );
-      std::swap( G[1][i], G[2][i] ); std::swap( G[4][i], G[5][i] );
+   for( auto i = size_t{0}; i < enoStencilSize; i++ ){
+      std::swap( U[1][i], U[2][i] ); std::swap( U[System::bx][i], U[System::by][i] );
+      std::swap( G[1][i], G[2][i] ); std::swap( G[System::bx][i], G[System::by][i] );
    }
 
    // find flux for inverted x and y
-   auto status = getNumericalFluxF( U1, U2, U, G, alpha, G_, cy, LUy, maxWaveSpeed );
+   auto status = getNumericalFluxF<S, R>( thread, slot, characteristic, U1, U2, U, G, alpha, G_, cy, LUy, maxWaveSpeed );
    if( status.status != ReturnStatus::OK ){
       status.message += "\n! SpatialMethodEnoLF::getNumericalFluxG";
    }
 
    // return found flux to proper axes
-   std::swap( G_[1], G_[2] ); std::swap( G_[4], G_[5] );
+   std::swap( G_[1], G_[2] ); std::swap( G_[System::bx], G_[System::by] );
 
    return status;
 }
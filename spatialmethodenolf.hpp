@@ -3,6 +3,25 @@
 
 #include "spatialmethodeno.hpp"
 
+// Reconstruction of the Lax-Friedrichs flux splitting
+enum class EnoLFSplitting {
+   Characteristic,   // in the characteristic fields of the face
+   Hybrid,           // characteristic where a discontinuity detector fires, else per variable
+   Componentwise     // per variable everywhere
+};
+
+// Reconstruction of the split fluxes at the faces
+enum class EnoLFReconstruction {
+   ENO,     // ENO of order r (2 to 4), from the smoothest r-point stencil (2r points per face)
+   WENO5    // fifth order WENO of Jiang and Shu, from three 3-point stencils (6 points per face)
+};
+
+// Viscosity coefficients alpha of the Lax-Friedrichs flux splitting
+enum class EnoLFViscosity {
+   Row,     // largest eigenvalue of the row (F) or column (G) of the face, per field
+   Local    // eigenvalue of the face itself, per field
+};
+
 class SpatialMethodEnoLF : public SpatialMethodEno
 {
    public:
@@ -13,6 +32,12 @@ class SpatialMethodEnoLF : public SpatialMethodEno
                                  , double       dy
                                  , t_boundary   boundary
                                  , double       gamma
+                                 , EnoSystem    system = EnoSystem::MHD
+                                 , EnoLFSplitting splitting = EnoLFSplitting::Characteristic
+                                 , double       hybridThreshold = 0.0
+                                 , EnoLFReconstruction reconstruction = EnoLFReconstruction::ENO
+                                 , size_t       order = 2
+                                 , EnoLFViscosity viscosity = EnoLFViscosity::Row
                                  );
       virtual ~SpatialMethodEnoLF();
 
@@ -21,28 +46,154 @@ class SpatialMethodEnoLF : public SpatialMethodEno
                         , borderVectors   borderFlux
                         , double         &dtIdeal
                         ) override;
+      t_status integrateStage( const t_stageUpdate  &stage
+                             , t_matrices            U
+                             , t_matrices            UL
+                             , borderVectors         borderFlux
+                             , double               &dtIdeal
+                             ) override;
+
+      // Buffer width needed by the stencils of reconstruction (with order for ENO)
+      static size_t requiredBufferWidth( EnoLFReconstruction reconstruction = EnoLFReconstruction::ENO
+                                       , size_t              order = 2 );
+
+      bool getFluxY( size_t     j
+                   , t_vectors  flux
+                   ) override;
+
+      bool setSkipUniform( bool skip
+                         ) override;
+
+      void printStatistics( std::ostream &out
+                          ) const override;
 
    protected:
+      void distributeMemory() override;
 
    private:
+      // Spatial integration step, after the stage update of U if stage is given
+      template<EnoSystem S>
+      t_status integrateState( const t_stageUpdate  *stage
+                             , t_matrices            U
+                             , t_matrices            UL
+                             , double               &dtIdeal );
+      // Same, with the reconstruction of order R (see order)
+      template<EnoSystem S, size_t R>
+      t_status integrateStencil( const t_stageUpdate  *stage
+                               , t_matrices            U
+                               , t_matrices            UL
+                               , double               &dtIdeal );
+      // Numerical flux G of row j for the system variables, zero for the others
+      template<EnoSystem S>
+      void getSystemFluxY( size_t     j
+                         , t_vectors  flux );
+
+      // per system variable (see t_enoSystem)
       t_vectors alphaF; // viscosity coefficients in the Lax-Friedrichs
-      t_vectors alphaG; //    flux splitting per row, column
+      t_vectors alphaG; //    flux splitting per row, column (not with local viscosity)
       t_matrices F_;  // numerical flux F
       t_matrices G_;  // numerical flux G
 
-      t_status getNumericalFluxF( double  U1[PRB_DIM]
+      // copy the numerical fluxes of faces whose stencil equals that of the previous face
+      bool skipUniform = false;
+      // numerical fluxes copied and in total, over all integrations
+      size_t fluxesSkipped = 0;
+      size_t fluxesTotal   = 0;
+
+      // reconstruction of the flux splitting; in hybrid mode, the faces whose detector exceeds
+      // hybridThreshold are characteristic, in componentwise mode none
+      const EnoLFSplitting splitting;
+      const double         hybridThreshold;
+      // computed and characteristic faces over all integrations, and the smallest and largest
+      // fraction of characteristic faces of an integration
+      size_t facesComputed       = 0;
+      size_t facesCharacteristic = 0;
+      double fractionMin         = 1.0;
+      double fractionMax         = 0.0;
+
+      // viscosity coefficients of the splitting; local ones need no pass over the rows and
+      // columns before the flux sweeps
+      const EnoLFViscosity viscosity;
+
+      // order of the reconstruction of the split fluxes: 2 to 4 for ENO, 5 for WENO5; the
+      // stencils are sized for it at compile time
+      const size_t order;
+
+      // Points of the stencil of reconstruction order R on either side of a face
+      static constexpr size_t stencilHalfWidth( size_t R ){ return R == 5 ? 3 : R; }
+
+      // Discontinuity detector of the face between (i,j) and (i+di,j+dj), from the four points of
+      // its stencil: true if the second difference of rho, p or a component of B at one of the
+      // two points next to the face exceeds hybridThreshold, relative to the sum of the values
+      // (of |B| + sqrt(2p) for B) in the second difference
+      bool isDiscontinuity( const t_matrices  U
+                          , size_t            i
+                          , size_t            j
+                          , size_t            di
+                          , size_t            dj ) const;
+      // true if the face between (i,j) and (i+di,j+dj) is reconstructed in the characteristic
+      // fields, depending on the splitting
+      bool isCharacteristic( const t_matrices  U
+                           , size_t            i
+                           , size_t            j
+                           , size_t            di
+                           , size_t            dj ) const;
+
+      // true if the points (i,j) - H*(di,dj) to (i,j) + H*(di,dj) of U are identical to the bit
+      template<size_t H>
+      bool isUniformStencil( const t_matrices  U
+                           , size_t            i
+                           , size_t            j
+                           , size_t            di
+                           , size_t            dj ) const;
+
+      // true if the points (i1,j1) and (i2,j2) of U are identical to the bit
+      static bool isSamePoint( const t_matrices  U
+                             , size_t            i1
+                             , size_t            j1
+                             , size_t            i2
+                             , size_t            j2 );
+
+      // Reconstruction of order R of the positive (wm) and negative (wp) part of the flux
+      // splitting at the face, from the characteristic variables (or variables) RU and fluxes RF
+      // around it, with viscosity coefficients alpha, for k < N
+      template<size_t R>
+      static void reconstructSplitting( size_t  N
+                                      , double  RU[PRB_DIM][enoStencilSize]
+                                      , double  RF[PRB_DIM][enoStencilSize]
+                                      , double  alpha[PRB_DIM]
+                                      , double  wm[PRB_DIM]
+                                      , double  wp[PRB_DIM] );
+
+      // Numerical flux F_ between points U1 and U2 from the points U and physical fluxes F
+      // around them (stencilHalfWidth( R ) points on either side of the face after enoFaceIndex);
+      // U, F, alpha and F_ are given per system variable, U1, U2, cx and LUx per
+      // variable of U and characteristic field; thread and slot
+      // select the eigensystem cache slot (see getEigensFCached). With local viscosity, alpha
+      // is not used, the eigenvalues of the face are. Without characteristic, the
+      // splitting is reconstructed per variable with the largest alpha, only the eigenvalues
+      // are computed, and LUx is zero
+      template<EnoSystem S, size_t R>
+      t_status getNumericalFluxF( size_t  thread
+                                , size_t  slot
+                                , bool    characteristic
+                                , double  U1[PRB_DIM]
                                 , double  U2[PRB_DIM]
-                                , double  U[PRB_DIM][8]
-                                , double  F[PRB_DIM][8]
+                                , double  U[PRB_DIM][enoStencilSize]
+                                , double  F[PRB_DIM][enoStencilSize]
                                 , double  alpha[PRB_DIM]
                                 , double  F_[PRB_DIM]
                                 , double  cx[PRB_DIM]
                                 , double  LUx[PRB_DIM]
                                 , double &maxWaveSpeed );
-      t_status getNumericalFluxG( double  U1[PRB_DIM]
+      template<EnoSystem S, size_t R>
+      t_status getNumericalFluxG( size_t  thread
+                                , size_t  slot
+                                , bool    characteristic
+                                , double  U1[PRB_DIM]
                                 , double  U2[PRB_DIM]
-                                , double  U[PRB_DIM][8]
-                                , double  G[PRB_DIM][8]
+                                , double  U[PRB_DIM][enoStencilSize]
+                                , double  G[PRB_DIM][enoStencilSize]
                                 , double  alpha[PRB_DIM]
                                 , double  G_[PRB_DIM]
                                 , double  cy[PRB_DIM]
@@ -10,9 +10,19 @@ SpatialMethodEnoRoe::SpatialMethodEnoRoe
    , double       dy
    , t_boundary   boundary
    , double       gamma
+   , size_t       order
 )
    : SpatialMethodEno{ nx, ny, bufferWidth, dx, dy, boundary, gamma }
+   , order{ order }
 {
+   if( order < 2 || order > enoMaxOrder ){
+      throw std::domain_error( "ENO order must be 2 to 4" );
+   }
+   if( bufferWidth < requiredBufferWidth( order ) ){
+      throw std::domain_error( "Buffer is too small for the ENO order;"
+                               " need at least " + std::to_string( order ) + " extra grids" );
+   }
+
    VUF = createMatrices( PRB_DIM, nxTotal, nyTotal );
    VUG = createMatrices( PRB_DIM, nxTotal, nyTotal );
    F_  = createMatrices( PRB_DIM, nxTotal, nyTotal );
@@ -29,133 +39,257 @@ SpatialMethodEnoRoe::~SpatialMethodEnoRoe
    freeMatrices( G_ );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodEnoRoe::distributeMemory
+   (
+){
+   SpatialMethodEno::distributeMemory();
+   scheduler->distribute( VUF, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( VUG, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( F_, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( G_, PRB_DIM, nxTotal, nyTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t SpatialMethodEnoRoe::requiredBufferWidth
+   ( size_t order
+){
+   return std::max( order, SpatialMethodEno::requiredBufferWidth() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 t_status SpatialMethodEnoRoe::integrate
    ( t_matrices      U
    , t_matrices      UL
    , borderVectors   /*borderFlux*/
    , double         &dtIdeal
+){
+   return integrateState( nullptr, U, UL, dtIdeal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialMethodEnoRoe::integrateStage
+   ( const t_stageUpdate  &stage
+   , t_matrices            U
+   , t_matrices            UL
+   , borderVectors         /*borderFlux*/
+   , double               &dtIdeal
+){
+   return integrateState( &stage, U, UL, dtIdeal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialMethodEnoRoe::integrateState
+   ( const t_stageUpdate  *stage
+   , t_matrices            U
+   , t_matrices            UL
+   , double               &dtIdeal
+){
+   switch( order ){
+      case 3:
+         return integrateStencil<3>( stage, U, UL, dtIdeal );
+      case 4:
+         return integrateStencil<4>( stage, U, UL, dtIdeal );
+      default:
+         return integrateStencil<2>( stage, U, UL, dtIdeal );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<size_t R>
+t_status SpatialMethodEnoRoe::integrateStencil
+   ( const t_stageUpdate  *stage
+   , t_matrices            U
+   , t_matrices            UL
+   , double               &dtIdeal
 ){
    // for processing function return values
    auto status = t_status{};
-   // track maximum wave speeds (i.e., eigenvalues)
-   auto maxWaveSpeedX = double{0.0};
-   auto maxWaveSpeedY = double{0.0};
-
-   // temporary storage for function calls
-   const auto TN      = size_t{8};
-   const auto TNFIRST = size_t{2};
-   //const auto TNLAST  = size_t{6};
-   double tU1[PRB_DIM], tU2[PRB_DIM];
-   double tF[PRB_DIM][TN], tVUF[PRB_DIM][TN-1], tF_[PRB_DIM];
-   double tc[PRB_DIM], tLU[PRB_DIM];
-   auto tMaxWaveSpeed = double{};
-
-   // first, boundary conditions
-   status = applyBoundaryConditions( U );
-   if( status.isError ){
-      status.message += "\n! SpatialMethodEnoRoe::integrate";
-      return status;
-   }
 
-   // data is ready, calculate fluxes
-   updateFluxes( U );
 
-   // undivided differences V_UF, V_UG
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      for( auto i = nxFirst-2; i < nxLast+1; i++ ){
-         for( auto j = nyFirst-2; j < nyLast+1; j++ ){
-            VUF[k][i][j] = F[k][i+1][j] - F[k][i][j];
-            VUG[k][i][j] = G[k][i][j+1] - G[k][i][j];
+   // results of the individual phases
+   TileResults boundaryResults{ scheduler->getThreadCount() };
+   TileResults fluxResultsF{ scheduler->getThreadCount() };
+   TileResults fluxResultsG{ scheduler->getThreadCount() };
+   auto failed = [&](){
+      return boundaryResults.failed() || fluxResultsF.failed() || fluxResultsG.failed();
+   };
+
+   // phases of the integration step; F and G parts are processed at the same time
+   TileGraph graph;
+
+   // first, boundary conditions and physical fluxes
+   auto boundaries = std::vector<TileGraph::t_node>{};
+   auto fluxes     = std::vector<TileGraph::t_node>{};
+   addStateTasks( graph, U, stage, boundaryResults, failed, boundaries, fluxes );
+
+   // undivided differences V_UF, V_UG, over the stencils of the faces
+   auto differencesF = graph.addTask( nxFirst-R, nxLast+R-1, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+      if( failed() ) return;
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            for( auto j = nyFirst-R; j < nyLast+R-1; j++ ){
+               VUF[k][i][j] = F[k][i+1][j] - F[k][i][j];
+            }
          }
       }
-   }
+   }, fluxes );
+   auto differencesG = graph.addTask( nxFirst-R, nxLast+R-1, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+      if( oneDimensional || failed() ) return;
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            for( auto j = nyFirst-R; j < nyLast+R-1; j++ ){
+               VUG[k][i][j] = G[k][i][j+1] - G[k][i][j];
+            }
+         }
+      }
+   }, fluxes );
 
    /******************************
     *           F flux           *
     ******************************/
-   for( auto i = nxFirst-1; i < nxLast; i++ ){
-      for( auto j = nyFirst; j < nyLast; j++ ){
-         // prepare data
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            if( boundary.left == BoundaryCondition::Open && i < nxFirst ){
-               tU1[k] = U[k][i+1][j];       // left point
-            } else {
-               tU1[k] = U[k][i][j];         // left point
-            }
-            if( boundary.right == BoundaryCondition::Open && i > nxLast-2 ){
-               tU2[k] = U[k][i][j];         // right point
-            } else {
-               tU2[k] = U[k][i+1][j];       // right point
-            }
-            for( auto l = size_t{0}; l < 4; l++ ){
-               tF[k][TNFIRST+l] = F[k][i-1+l][j]; // physical flux
-            }
-            for( auto l = size_t{0}; l < 3; l++ ){
-               tVUF[k][TNFIRST+l] = VUF[k][i-1+l][j]; // undivided differences
+   auto sweepF = graph.addTask( nxFirst-1, nxLast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+      double tU1[PRB_DIM], tU2[PRB_DIM];
+      double tF[PRB_DIM][enoStencilSize], tVUF[PRB_DIM][enoStencilSize-1], tF_[PRB_DIM];
+      double tc[PRB_DIM], tLU[PRB_DIM];
+      auto tMaxWaveSpeed = double{};
+
+      for( auto i = iFirst; i < iLast; i++ ){
+         for( auto j = nyFirst; j < nyLast; j++ ){
+            if( failed() ) return;
+
+            // prepare data
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               if( boundary.left == BoundaryCondition::Open && i < nxFirst ){
+                  tU1[k] = U[k][i+1][j];       // left point
+               } else {
+                  tU1[k] = U[k][i][j];         // left point
+               }
+               if( boundary.right == BoundaryCondition::Open && i > nxLast-2 ){
+                  tU2[k] = U[k][i][j];         // right point
+               } else {
+                  tU2[k] = U[k][i+1][j];       // right point
+               }
+               for( auto l = enoFaceIndex+1-R; l <= enoFaceIndex+R; l++ ){
+                  tF[k][l] = F[k][i+l-enoFaceIndex][j]; // physical flux
+               }
+               for( auto l = enoFaceIndex+1-R; l < enoFaceIndex+R; l++ ){
+                  tVUF[k][l] = VUF[k][i+l-enoFaceIndex][j]; // undivided differences
+               }
             }
-         }
 
-         // find numerical flux
-         status = getNumericalFluxF( tU1, tU2, tF, tVUF, tF_, tc, tLU, tMaxWaveSpeed );
-         if( status.isError ){
-            status.message += "\n! SpatialMethodEnoRoe::integrate: F flux";
-            return status;
-         }
+            // find numerical flux
+            auto pointStatus = getNumericalFluxF<R>( thread, j, tU1, tU2, tF, tVUF, tF_, tc, tLU, tMaxWaveSpeed );
+            if( pointStatus.isError ){
+               pointStatus.message += "\n! SpatialMethodEnoRoe::integrate: F flux";
+               fluxResultsF.setError( thread, i*nyTotal+j, pointStatus );
+               return;
+            }
 
-         //process results
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            F_[k][i][j]    = tF_[k];
-            _cx[k][i][j]   = tc[k];
-            _LUx[k][i][j]  = tLU[k];
+            //process results
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               F_[k][i][j]    = tF_[k];
+               _cx[k][i][j]   = tc[k];
+               _LUx[k][i][j]  = tLU[k];
+            }
+            fluxResultsF.updateMax( thread, tMaxWaveSpeed*faceScaleX( i ) );
          }
-         if( tMaxWaveSpeed > maxWaveSpeedX )
-            maxWaveSpeedX = tMaxWaveSpeed;
       }
-   }
+   }, { differencesF } );
 
    /******************************
     *           G flux           *
     ******************************/
-   for( auto i = nxFirst; i < nxLast; i++ ){
-      for( auto j = nyFirst-1; j < nyLast; j++ ){
-         // prepare data
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            if( boundary.bottom == BoundaryCondition::Open && j < nyFirst ){
-               tU1[k] = U[k][i][j+1];       // down point
-            } else {
-               tU1[k] = U[k][i][j];         // down point
-            }
-            if( boundary.top == BoundaryCondition::Open && j > nyLast-2 ){
-               tU2[k] = U[k][i][j];         // up point
-            } else {
-               tU2[k] = U[k][i][j+1];       // up point
+   auto sweepG = graph.addTask( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+      double tU1[PRB_DIM], tU2[PRB_DIM];
+      double tF[PRB_DIM][enoStencilSize], tVUF[PRB_DIM][enoStencilSize-1], tF_[PRB_DIM];
+      double tc[PRB_DIM], tLU[PRB_DIM];
+      auto tMaxWaveSpeed = double{};
+      if( oneDimensional ) return;
+
+      for( auto i = iFirst; i < iLast; i++ ){
+         for( auto j = nyFirst-1; j < nyLast; j++ ){
+            if( failed() ) return;
+
+            // prepare data
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               if( boundary.bottom == BoundaryCondition::Open && !mirrorBottom && j < nyFirst ){
+                  tU1[k] = U[k][i][j+1];       // down point
+               } else {
+                  tU1[k] = U[k][i][j];         // down point
+               }
+               if( boundary.top == BoundaryCondition::Open && j > nyLast-2 ){
+                  tU2[k] = U[k][i][j];         // up point
+               } else {
+                  tU2[k] = U[k][i][j+1];       // up point
+               }
+               for( auto l = enoFaceIndex+1-R; l <= enoFaceIndex+R; l++ ){
+                  tF[k][l] = G[k][i][j+l-enoFaceIndex]; // physical flux
+               }
+               for( auto l = enoFaceIndex+1-R; l < enoFaceIndex+R; l++ ){
+                  tVUF[k][l] = VUG[k][i][j+l-enoFaceIndex]; // undivided differences
+               }
             }
-            for( auto l = size_t{0}; l < 4; l++ ){
-               tF[k][TNFIRST+l] = G[k][i][j-1+l]; // physical flux
-            }
-            for( auto l = size_t{0}; l < 3; l++ ){
-               tVUF[k][TNFIRST+l] = VUG[k][i][j-1+l]; // undivided differences
+
+            // find numerical flux
+            auto pointStatus = getNumericalFluxG<R>( thread, nyTotal+j, tU1, tU2, tF, tVUF, tF_, tc, tLU, tMaxWaveSpeed );
+            if( pointStatus.isError ){
+               pointStatus.message += "\n! SpatialMethodEnoRoe::integrate: G flux";
+               fluxResultsG.setError( thread, i*nyTotal+j, pointStatus );
+               return;
             }
-         }
 
-         // find numerical flux
-         status = getNumericalFluxG( tU1, tU2, tF, tVUF, tF_, tc, tLU, tMaxWaveSpeed );
-         if( status.isError ){
-            status.message += "\n! SpatialMethodEnoRoe::integrate: G flux";
-            return status;
+            //process results
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               G_[k][i][j]    = tF_[k];
+               _cy[k][i][j]   = tc[k];
+               _LUy[k][i][j]  = tLU[k];
+            }
+            fluxResultsG.updateMax( thread, tMaxWaveSpeed*faceScaleY( j ) );
          }
+      }
+   }, { differencesG } );
 
-         //process results
-         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-            G_[k][i][j]    = tF_[k];
-            _cy[k][i][j]   = tc[k];
-            _LUy[k][i][j]  = tLU[k];
+   // use numerical fluxes to calculate dU/dt
+   graph.addTask( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+      if( failed() ) return;
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            if( oneDimensional ){
+               for( auto j = nyFirst; j < nyLast; j++ ){
+                  UL[k][i][j] = -dxInv[i]*( F_[k][i][j] - F_[k][i-1][j] );
+               }
+               continue;
+            }
+            for( auto j = nyFirst; j < nyLast; j++ ){
+               UL[k][i][j] = -dxInv[i]*( F_[k][i][j] - F_[k][i-1][j] )
+                             -dyInv[j]*( G_[k][i][j] - G_[k][i][j-1] );
+            }
          }
-         if( tMaxWaveSpeed > maxWaveSpeedY )
-            maxWaveSpeedY = tMaxWaveSpeed;
       }
+      if( alfvenLimitInv2 > 0.0 ){
+         applyAlfvenLimit( U, UL, iFirst, iLast );
+      }
+   }, { sweepF, sweepG } );
+
+   scheduler->run( graph );
+
+   // errors are reported in the order of the phases
+   if( boundaryResults.failed() ){
+      status = boundaryResults.getError();
+      status.message += "\n! SpatialMethodEnoRoe::integrate";
+      return status;
+   }
+   if( fluxResultsF.failed() ){
+      return fluxResultsF.getError();
    }
+   if( fluxResultsG.failed() ){
+      return fluxResultsG.getError();
+   }
+
+   // track maximum wave speeds (i.e., eigenvalues)
+   auto maxWaveSpeedX = fluxResultsF.getMax();
+   auto maxWaveSpeedY = fluxResultsG.getMax();
 
    #ifdef DEBUG_MAX_VELOCITY
       OUT << "*** DEBUG: maxWaveSpeedX = " << maxWaveSpeedX
@@ -163,41 +297,33 @@ t_status SpatialMethodEnoRoe::integrate
    #endif // DEBUG_MAX_VELOCITY
 
    // update local dt from max wave speeds
-   dtIdeal = std::min( dx/maxWaveSpeedX, dy/maxWaveSpeedY );
-
-   // use numerical fluxes to calculate dU/dt
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      for( auto i = nxFirst; i < nxLast; i++ ){
-         for( auto j = nyFirst; j < nyLast; j++ ){
-            UL[k][i][j] = -(1.0/dx)*( F_[k][i][j] - F_[k][i-1][j] )
-                          -(1.0/dy)*( G_[k][i][j] - G_[k][i][j-1] );
-         }
-      }
-   }
+   dtIdeal = oneDimensional ? dx/maxWaveSpeedX : std::min( dx/maxWaveSpeedX, dy/maxWaveSpeedY );
 
    return status;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<size_t R>
 t_status SpatialMethodEnoRoe::getNumericalFluxF
-   ( double    U1[PRB_DIM]
+   ( size_t    thread
+   , size_t    slot
+   , double    U1[PRB_DIM]
    , double    U2[PRB_DIM]
-   , double    F[PRB_DIM][8]
-   , double    VUF[PRB_DIM][7]
+   , double    F[PRB_DIM][enoStencilSize]
+   , double    VUF[PRB_DIM][enoStencilSize-1]
    , double    F_[PRB_DIM]
    , double    cx[PRB_DIM]
    , double    LUx[PRB_DIM]
    , double   &maxWaveSpeed
 ){
-   const auto TNFIRST = size_t{2};
    // current index
-   const auto i = TNFIRST+1;
+   const auto i = enoFaceIndex;
 
    // eigenvalues & eigenvectors @ u_(i+1/2)
    auto a = cx;
-   double lv[PRB_DIM][PRB_DIM], rv[PRB_DIM][PRB_DIM];
+   double (*lv)[PRB_DIM], (*rv)[PRB_DIM];
    // characteristics and differences
-   double w[PRB_DIM][8], Vw[PRB_DIM][7];
+   double w[PRB_DIM][enoStencilSize], Vw[PRB_DIM][enoStencilSize-1];
    // fluxes on minus edge, plus edge, and final
    double wm[PRB_DIM], wp[PRB_DIM], fw[PRB_DIM];
 
@@ -205,7 +331,7 @@ t_status SpatialMethodEnoRoe::getNumericalFluxF
    maxWaveSpeed = 0.0;
 
    // eigensystem
-   auto status = getEigensF( U1, U2, a, lv, rv );
+   auto status = getEigensFCached( thread, slot, U1, U2, a, lv, rv );
    if( status.status != ReturnStatus::OK ){
       status.message += "\n! SpatialMethodEnoRoe::getNumericalFluxF";
    }
@@ -221,14 +347,14 @@ t_status SpatialMethodEnoRoe::getNumericalFluxF
 
    // local characteristics and undivided differences
    for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      for( auto l = i-1; l <= i+2; l++ ){
+      for( auto l = i+1-R; l <= i+R; l++ ){
          w[k][l] = 0.0;
          for( auto m = size_t{0}; m < PRB_DIM; m++ )
             w[k][l] += lv[k][m]*F[m][l];
       }
    }
    for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      for( auto l = i-1; l <= i+1; l++ ){
+      for( auto l = i+1-R; l < i+R; l++ ){
          Vw[k][l] = 0.0;
          for( auto m = size_t{0}; m < PRB_DIM; m++ )
             Vw[k][l] += lv[k][m]*VUF[m][l];
@@ -237,20 +363,10 @@ t_status SpatialMethodEnoRoe::getNumericalFluxF
 
    // TODO: set up boundaries for open boundary conditions
 
-   // minus edge
-   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      if( ABS(Vw[k][i-1]) < ABS(Vw[k][i]) ) // left (stencil -3/2, -1/2, +1/2)
-         wm[k] = -(1.0/2.0)*w[k][i-1] + (3.0/2.0)*w[k][i];
-      else // right (stencil -1/2, +1/2, +3/2)
-         wm[k] = (1.0/2.0)*w[k][i] + (1.0/2.0)*w[k][i+1];
-   }
-
-   // plus edge
+   // minus edge (upwind from the left) and plus edge (upwind from the right)
    for( auto k = size_t{0}; k < PRB_DIM; k++ ){
-      if( ABS(Vw[k][i]) < ABS(Vw[k][i+1]) ) // left (stencil -3/2, -1/2, +1/2)
-         wp[k] = (1.0/2.0)*w[k][i] + (1.0/2.0)*w[k][i+1];
-      else // right (stencil -1/2, +1/2, +3/2)
-         wp[k] = (3.0/2.0)*w[k][i+1] - (1.0/2.0)*w[k][i+2];
+      wm[k] = enoReconstruct<R>( w[k], Vw[k], i, i );
+      wp[k] = enoReconstruct<R>( w[k], Vw[k], i, i+1 );
    }
 
    // fluxes
@@ -282,11 +398,14 @@ t_status SpatialMethodEnoRoe::getNumericalFluxF
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<size_t R>
 t_status SpatialMethodEnoRoe::getNumericalFluxG
-   ( double    U1[PRB_DIM]
+   ( size_t    thread
+   , size_t    slot
+   , double    U1[PRB_DIM]
    , double    U2[PRB_DIM]
-   , double    G[PRB_DIM][8]
-   , double    VUG[PRB_DIM][7]
+   , double    G[PRB_DIM][enoStencilSize]
+   , double    VUG[PRB_DIM][enoStencilSize-1]
    , double    G_[PRB_DIM]
    , double    cy[PRB_DIM]
    , double    LUy[PRB_DIM]
@@ -295,15 +414,15 @@ t_status SpatialMethodEnoRoe::getNumericalFluxG
    // invert x and y axis
    std::swap( U1[1], U1[2] ); std::swap( U1[4], U1[5] );
    std::swap( U2[1], U2[2] ); std::swap( U2[4], U2[5] );
-   for( auto i = size_t{0}; i < 8; i++ ){
+   for( auto i = size_t{0}; i < enoStencilSize; i++ ){
       std::swap( G[1][i], G[2][i] ); std::swap( G[4][i], G[5][i] );
    }
-   for( auto i = size_t{0}; i < 7; i++ ){
+   for( auto i = size_t{0}; i < enoStencilSize-1; i++ ){
       std::swap( VUG[1][i], VUG[2][i] ); std::swap( VUG[4][i], VUG[5][i] );
    }
 
    // find flux for inverted x and y
-   auto status = getNumericalFluxF( U1, U2, G, VUG, G_, cy, LUy, maxWaveSpeed );
+   auto status = getNumericalFluxF<R>( thread, slot, U1, U2, G, VUG, G_, cy, LUy, maxWaveSpeed );
    if( status.status != ReturnStatus::OK ){
       status.message += "\n! SpatialMethodEnoRoe::getNumericalFluxG";
    }
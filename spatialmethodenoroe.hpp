@@ -13,6 +13,7 @@ class SpatialMethodEnoRoe : public SpatialMethodEno
                                   , double      dy
                                   , t_boundary  boundary
                                   , double      gamma
+                                  , size_t      order = 2
                                   );
       virtual ~SpatialMethodEnoRoe();
 
@@ -21,27 +22,58 @@ class SpatialMethodEnoRoe : public SpatialMethodEno
                         , borderVectors   borderFlux
                         , double         &dtIdeal
                         ) override;
+      t_status integrateStage( const t_stageUpdate  &stage
+                             , t_matrices            U
+                             , t_matrices            UL
+                             , borderVectors         borderFlux
+                             , double               &dtIdeal
+                             ) override;
+
+      // Buffer width needed by the stencils of the ENO reconstruction of order
+      static size_t requiredBufferWidth( size_t order = 2 );
 
    protected:
+      void distributeMemory() override;
 
    private:
+      // Spatial integration step, after the stage update of U if stage is given
+      t_status integrateState( const t_stageUpdate  *stage
+                             , t_matrices            U
+                             , t_matrices            UL
+                             , double               &dtIdeal );
+      // Same, with the ENO reconstruction of order R
+      template<size_t R>
+      t_status integrateStencil( const t_stageUpdate  *stage
+                               , t_matrices            U
+                               , t_matrices            UL
+                               , double               &dtIdeal );
+
+      // order of the ENO reconstruction; the stencils are sized for it at compile time
+      const size_t order;
+
       t_matrices VUF; // undivided differences, flux F
       t_matrices VUG; // undivided differences, flux G
       t_matrices F_;  // numerical flux F
       t_matrices G_;  // numerical flux G
 
-      t_status getNumericalFluxF( double  U1[PRB_DIM]
+      template<size_t R>
+      t_status getNumericalFluxF( size_t  thread
+                                , size_t  slot
+                                , double  U1[PRB_DIM]
                                 , double  U2[PRB_DIM]
-                                , double  F[PRB_DIM][8]
-                                , double  VUF[PRB_DIM][7]
+                                , double  F[PRB_DIM][enoStencilSize]
+                                , double  VUF[PRB_DIM][enoStencilSize-1]
                                 , double  F_[PRB_DIM]
                                 , double  cx[PRB_DIM]
                                 , double  LUx[PRB_DIM]
                                 , double &maxWaveSpeed );
-      t_status getNumericalFluxG( double  U1[PRB_DIM]
+      template<size_t R>
+      t_status getNumericalFluxG( size_t  thread
+                                , size_t  slot
+                                , double  U1[PRB_DIM]
                                 , double  U2[PRB_DIM]
-                                , double  G[PRB_DIM][8]
-                                , double  VUG[PRB_DIM][7]
+                                , double  G[PRB_DIM][enoStencilSize]
+                                , double  VUG[PRB_DIM][enoStencilSize-1]
                                 , double  G_[PRB_DIM]
                                 , double  cy[PRB_DIM]
                                 , double  LUy[PRB_DIM]
@@ -0,0 +1,483 @@
+#include "spatialmethodhlld.hpp"
+
+#include <stdexcept>
+
+namespace {
+   // minmod-limited slope from the differences to the left and right neighbour
+   inline double minmod( double a
+                       , double b )
+   {
+      if( a*b <= 0.0 ) return 0.0;
+      return ABS(a) < ABS(b) ? a : b;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+SpatialMethodHLLD::SpatialMethodHLLD
+   ( size_t       nx
+   , size_t       ny
+   , size_t       bufferWidth
+   , double       dx
+   , double       dy
+   , t_boundary   boundary
+   , double       gamma
+)
+   : SpatialIntegrationMethod{ nx, ny, bufferWidth, dx, dy, boundary, gamma }
+{
+   if( bufferWidth < minimumBufferWidth ){
+      throw std::domain_error( "Buffer is too small for HLLD;"
+                               " need at least 2 extra grids" );
+   }
+
+   W   = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   F_  = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   G_  = createMatrices( PRB_DIM, nxTotal, nyTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+SpatialMethodHLLD::~SpatialMethodHLLD
+   (
+){
+   freeMatrices( W );
+   freeMatrices( F_ );
+   freeMatrices( G_ );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodHLLD::distributeMemory
+   (
+){
+   scheduler->distribute( W, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( F_, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( G_, PRB_DIM, nxTotal, nyTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t SpatialMethodHLLD::requiredBufferWidth
+   (
+){
+   return minimumBufferWidth;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool SpatialMethodHLLD::setOneDimensional
+   ( bool oneDimensional
+){
+   this->oneDimensional = oneDimensional;
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodHLLD::printStatistics
+   ( std::ostream &out
+) const {
+   if( fluxesTotal > 0 ){
+      out << " - HLL fallback       : " << 100.0*fluxesFallback/fluxesTotal
+          << "% of the numerical fluxes\n";
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status SpatialMethodHLLD::integrate
+   ( t_matrices      U
+   , t_matrices      UL
+   , borderVectors   /*borderFlux*/
+   , double         &dtIdeal
+){
+   auto status = t_status{ false, ReturnStatus::OK, std::string{} };
+
+   // results of the individual phases
+   TileResults boundaryResults{ scheduler->getThreadCount() };
+   TileResults primitiveResults{ scheduler->getThreadCount() };
+   TileResults fluxResultsF{ scheduler->getThreadCount() };
+   TileResults fluxResultsG{ scheduler->getThreadCount() };
+   auto failed = [&](){
+      return boundaryResults.failed() || primitiveResults.failed();
+   };
+   // numerical fluxes computed, HLL fallbacks and points with negative pressure, per thread
+   std::vector<size_t> computed( scheduler->getThreadCount(), 0 );
+   std::vector<size_t> fallbacks( scheduler->getThreadCount(), 0 );
+   std::vector<size_t> negativePressure( scheduler->getThreadCount(), 0 );
+
+   TileGraph graph;
+
+   // first, boundary conditions
+   auto boundaries = addBoundaryTasks( graph, U, boundaryResults );
+
+   // primitive variables of the active rows with their buffers; the corners are not used
+   auto jFirst = oneDimensional ? rowFirst : rowFirst-minimumBufferWidth;
+   auto jLast  = oneDimensional ? rowLast  : rowLast+minimumBufferWidth;
+   auto primitives = graph.addTask( nxFirst-minimumBufferWidth, nxLast+minimumBufferWidth, [&]( size_t iFirst, size_t iLast, size_t thread ){
+      if( failed() ) return;
+      for( auto i = iFirst; i < iLast; i++ ){
+         for( auto j = jFirst; j < jLast; j++ ){
+            if( ( i < nxFirst || i >= nxLast ) && ( j < nyFirst || j >= nyLast ) ) continue;
+
+            auto r = U[0][i][j];
+            if( r <= 0.0 ){
+               primitiveResults.setError( thread, i*nyTotal+j
+                  , { true, ReturnStatus::ErrorNegativeDensity
+                    , std::string{} + "negative density encountered "
+                    + "( i = " + std::to_string( int(i)-int(nxFirst) )
+                    + ", j = " + std::to_string( int(j)-int(nyFirst) ) + " )"
+                    + "\n! SpatialMethodHLLD::integrate" } );
+               return;
+            }
+            auto u  = U[1][i][j]/r;
+            auto v  = U[2][i][j]/r;
+            auto w  = U[3][i][j]/r;
+            auto bx = U[4][i][j];
+            auto by = U[5][i][j];
+            auto bz = U[6][i][j];
+            auto p  = (gamma-1.0)*( U[7][i][j] - 0.5*r*( u*u + v*v + w*w ) - 0.5*( bx*bx + by*by + bz*bz ) );
+            if( p < 0.0 ){
+               p = 0.0;
+               negativePressure[thread]++;
+            }
+
+            W[0][i][j] = r;
+            W[1][i][j] = u;
+            W[2][i][j] = v;
+            W[3][i][j] = w;
+            W[4][i][j] = bx;
+            W[5][i][j] = by;
+            W[6][i][j] = bz;
+            W[7][i][j] = p;
+         }
+      }
+   }, boundaries );
+
+   /******************************
+    *           F flux           *
+    ******************************/
+   auto sweepF = graph.addTask( nxFirst-1, nxLast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+      double tWL[PRB_DIM], tWR[PRB_DIM], tF_[PRB_DIM];
+      auto tMaxWaveSpeed = double{};
+      auto tFallback = bool{};
+      if( failed() ) return;
+
+      for( auto i = iFirst; i < iLast; i++ ){
+         for( auto j = rowFirst; j < rowLast; j++ ){
+            // reconstruct both sides of face i+1/2; an open boundary face takes the state of its
+            // interior side
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               tWL[k] = W[k][i][j]   + 0.5*minmod( W[k][i][j] - W[k][i-1][j], W[k][i+1][j] - W[k][i][j] );
+               tWR[k] = W[k][i+1][j] - 0.5*minmod( W[k][i+1][j] - W[k][i][j], W[k][i+2][j] - W[k][i+1][j] );
+            }
+            if( boundary.left == BoundaryCondition::Open && i < nxFirst ){
+               std::copy( tWR, tWR+PRB_DIM, tWL );
+            }
+            if( boundary.right == BoundaryCondition::Open && i > nxLast-2 ){
+               std::copy( tWL, tWL+PRB_DIM, tWR );
+            }
+
+            getNumericalFluxF( tWL, tWR, tF_, tMaxWaveSpeed, tFallback );
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               F_[k][i][j] = tF_[k];
+            }
+            computed[thread]++;
+            if( tFallback ) fallbacks[thread]++;
+            fluxResultsF.updateMax( thread, tMaxWaveSpeed*faceScaleX( i ) );
+         }
+      }
+   }, { primitives } );
+
+   /******************************
+    *           G flux           *
+    ******************************/
+   auto sweepG = graph.addTask( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+      double tWL[PRB_DIM], tWR[PRB_DIM], tG_[PRB_DIM];
+      auto tMaxWaveSpeed = double{};
+      auto tFallback = bool{};
+      if( oneDimensional || failed() ) return;
+
+      for( auto i = iFirst; i < iLast; i++ ){
+         for( auto j = rowFirst-1; j < rowLast; j++ ){
+            // reconstruct both sides of face j+1/2
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               tWL[k] = W[k][i][j]   + 0.5*minmod( W[k][i][j] - W[k][i][j-1], W[k][i][j+1] - W[k][i][j] );
+               tWR[k] = W[k][i][j+1] - 0.5*minmod( W[k][i][j+1] - W[k][i][j], W[k][i][j+2] - W[k][i][j+1] );
+            }
+            if( boundary.bottom == BoundaryCondition::Open && !mirrorBottom && j < nyFirst ){
+               std::copy( tWR, tWR+PRB_DIM, tWL );
+            }
+            if( boundary.top == BoundaryCondition::Open && j > nyLast-2 ){
+               std::copy( tWL, tWL+PRB_DIM, tWR );
+            }
+
+            getNumericalFluxG( tWL, tWR, tG_, tMaxWaveSpeed, tFallback );
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               G_[k][i][j] = tG_[k];
+            }
+            computed[thread]++;
+            if( tFallback ) fallbacks[thread]++;
+            fluxResultsG.updateMax( thread, tMaxWaveSpeed*faceScaleY( j ) );
+         }
+      }
+   }, { primitives } );
+
+   // use numerical fluxes to calculate dU/dt
+   graph.addTask( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+      if( failed() ) return;
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            if( oneDimensional ){
+               for( auto j = rowFirst; j < rowLast; j++ ){
+                  UL[k][i][j] = -dxInv[i]*( F_[k][i][j] - F_[k][i-1][j] );
+               }
+               continue;
+            }
+            for( auto j = rowFirst; j < rowLast; j++ ){
+               UL[k][i][j] = -dxInv[i]*( F_[k][i][j] - F_[k][i-1][j] )
+                             -dyInv[j]*( G_[k][i][j] - G_[k][i][j-1] );
+            }
+         }
+      }
+   }, { sweepF, sweepG } );
+
+   scheduler->run( graph );
+
+   // errors are reported in the order of the phases
+   if( boundaryResults.failed() ){
+      status = boundaryResults.getError();
+      status.message += "\n! SpatialMethodHLLD::integrate";
+      return status;
+   }
+   if( primitiveResults.failed() ){
+      return primitiveResults.getError();
+   }
+
+   for( auto t = size_t{0}; t < computed.size(); t++ ){
+      fluxesTotal    += computed[t];
+      fluxesFallback += fallbacks[t];
+      if( negativePressure[t] > 0 ){
+         status = { false, ReturnStatus::ErrorNegativePressure
+                  , "negative pressure encountered\n! SpatialMethodHLLD::integrate" };
+      }
+   }
+   if( status.status == ReturnStatus::ErrorNegativePressure && !shownPressureWarning ){
+      ERROUT << "WARNING: SpatialMethodHLLD: Negative pressure encountered!\n"
+             << "         Results from this point on are suspect.\n"
+             << "         Simulation resumed with pressure forced to zero.\n";
+      shownPressureWarning = true;
+   }
+
+   // update local dt from max wave speeds
+   auto maxWaveSpeedX = fluxResultsF.getMax();
+   auto maxWaveSpeedY = fluxResultsG.getMax();
+   dtIdeal = oneDimensional ? dx/maxWaveSpeedX : std::min( dx/maxWaveSpeedX, dy/maxWaveSpeedY );
+
+   return status;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodHLLD::getStateFlux
+   ( const double  W[PRB_DIM]
+   , double        bn
+   , double        U[PRB_DIM]
+   , double        F[PRB_DIM]
+) const {
+   auto r  = W[0];
+   auto u  = W[1];
+   auto v  = W[2];
+   auto w  = W[3];
+   auto by = W[5];
+   auto bz = W[6];
+   auto bb = bn*bn + by*by + bz*bz;
+   auto ub = u*bn + v*by + w*bz;
+   auto pt = W[7] + 0.5*bb;
+   auto e  = W[7]/(gamma-1.0) + 0.5*r*( u*u + v*v + w*w ) + 0.5*bb;
+
+   U[0] = r;
+   U[1] = r*u;
+   U[2] = r*v;
+   U[3] = r*w;
+   U[4] = bn;
+   U[5] = by;
+   U[6] = bz;
+   U[7] = e;
+
+   /* rho */ F[0] = r*u;
+   /* mx  */ F[1] = r*u*u + pt - bn*bn;
+   /* my  */ F[2] = r*u*v - bn*by;
+   /* mz  */ F[3] = r*u*w - bn*bz;
+   /* bx  */ F[4] = 0.0;
+   /* by  */ F[5] = by*u - bn*v;
+   /* bz  */ F[6] = bz*u - bn*w;
+   /* e   */ F[7] = (e+pt)*u - bn*ub;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double SpatialMethodHLLD::getFastSpeed
+   ( const double  W[PRB_DIM]
+   , double        bn
+) const {
+   auto a2  = gamma*W[7]/W[0];
+   auto b2  = ( bn*bn + W[5]*W[5] + W[6]*W[6] )/W[0];
+   auto ca2 = bn*bn/W[0];
+   auto c2  = a2 + b2;
+   auto ctemp = c2*c2 - 4.0*a2*ca2; if( ctemp < 0.0 ) ctemp = 0.0;
+
+   return sqrt( 0.5*( c2 + sqrt(ctemp) ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodHLLD::getNumericalFluxF
+   ( const double  WL[PRB_DIM]
+   , const double  WR[PRB_DIM]
+   , double        F_[PRB_DIM]
+   , double       &maxWaveSpeed
+   , bool         &fallback
+) const {
+   // normal magnetic field of the face
+   auto bn  = 0.5*( WL[4] + WR[4] );
+   auto bn2 = bn*bn;
+
+   // states and fluxes on both sides
+   double UL[PRB_DIM], UR[PRB_DIM], FL[PRB_DIM], FR[PRB_DIM];
+   getStateFlux( WL, bn, UL, FL );
+   getStateFlux( WR, bn, UR, FR );
+
+   // outer wave speeds, eq. (67)
+   auto cf = std::max( getFastSpeed( WL, bn ), getFastSpeed( WR, bn ) );
+   auto SL = std::min( WL[1], WR[1] ) - cf;
+   auto SR = std::max( WL[1], WR[1] ) + cf;
+   maxWaveSpeed = std::max( ABS(SL), ABS(SR) );
+   fallback = false;
+
+   // supersonic: upwind flux
+   if( SL >= 0.0 ){
+      std::copy( FL, FL+PRB_DIM, F_ );
+      return;
+   }
+   if( SR <= 0.0 ){
+      std::copy( FR, FR+PRB_DIM, F_ );
+      return;
+   }
+
+   // total pressures, speed of the contact discontinuity, eq. (38), and total pressure of
+   // the intermediate states, eq. (41)
+   auto ptL = WL[7] + 0.5*( bn2 + WL[5]*WL[5] + WL[6]*WL[6] );
+   auto ptR = WR[7] + 0.5*( bn2 + WR[5]*WR[5] + WR[6]*WR[6] );
+   auto dL  = WL[0]*( SL - WL[1] );
+   auto dR  = WR[0]*( SR - WR[1] );
+   auto SM  = ( dR*WR[1] - dL*WL[1] - ptR + ptL )/( dR - dL );
+   auto pt  = ( dR*ptL - dL*ptR + dL*dR*( WR[1] - WL[1] ) )/( dR - dL );
+
+   // intermediate state U* behind the outer wave S of the side with primitive state Wa, state
+   // Ua and total pressure pta, eqs. (39)-(48); false if it is not physical
+   auto starState = [&]( const double Wa[PRB_DIM], const double Ua[PRB_DIM], double pta, double S, double Us[PRB_DIM] ){
+      auto r   = Wa[0]*( S - Wa[1] )/( S - SM );
+      auto den = Wa[0]*( S - Wa[1] )*( S - SM ) - bn2;
+      auto v   = Wa[2];
+      auto w   = Wa[3];
+      auto by  = Wa[5];
+      auto bz  = Wa[6];
+      // (the transverse components do not change if the outer wave degenerates into an
+      // Alfven wave)
+      if( ABS(den) > 1e-8*( pt + bn2 ) ){
+         auto fv = bn*( SM - Wa[1] )/den;
+         auto fb = ( Wa[0]*( S - Wa[1] )*( S - Wa[1] ) - bn2 )/den;
+         v  -= Wa[5]*fv;
+         w  -= Wa[6]*fv;
+         by *= fb;
+         bz *= fb;
+      }
+      auto ub  = Wa[1]*bn + Wa[2]*Wa[5] + Wa[3]*Wa[6];
+      auto ubs = SM*bn + v*by + w*bz;
+
+      Us[0] = r;
+      Us[1] = r*SM;
+      Us[2] = r*v;
+      Us[3] = r*w;
+      Us[4] = bn;
+      Us[5] = by;
+      Us[6] = bz;
+      Us[7] = ( ( S - Wa[1] )*Ua[7] - pta*Wa[1] + pt*SM + bn*( ub - ubs ) )/( S - SM );
+
+      return r > 0.0 && pt - 0.5*( bn2 + by*by + bz*bz ) >= 0.0;
+   };
+
+   double UsL[PRB_DIM], UsR[PRB_DIM];
+   if( !( dR - dL > 0.0 ) || !( SL < SM && SM < SR )
+       || !starState( WL, UL, ptL, SL, UsL ) || !starState( WR, UR, ptR, SR, UsR ) ){
+      // HLL flux with the same outer wave speeds
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         F_[k] = ( SR*FL[k] - SL*FR[k] + SL*SR*( UR[k] - UL[k] ) )/( SR - SL );
+      fallback = true;
+      return;
+   }
+
+   // rotational discontinuities, eq. (51)
+   auto sqL = sqrt( UsL[0] );
+   auto sqR = sqrt( UsR[0] );
+   auto SLs = SM - ABS(bn)/sqL;
+   auto SRs = SM + ABS(bn)/sqR;
+
+   if( SLs >= 0.0 ){
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         F_[k] = FL[k] + SL*( UsL[k] - UL[k] );
+      return;
+   }
+   if( SRs <= 0.0 ){
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         F_[k] = FR[k] + SR*( UsR[k] - UR[k] );
+      return;
+   }
+
+   // states between the rotational discontinuities, eqs. (59)-(63)
+   auto sgn = bn > 0.0 ? 1.0 : -1.0;
+   auto vL  = UsL[2]/UsL[0]; auto wL = UsL[3]/UsL[0];
+   auto vR  = UsR[2]/UsR[0]; auto wR = UsR[3]/UsR[0];
+   auto v   = ( sqL*vL + sqR*vR + ( UsR[5] - UsL[5] )*sgn )/( sqL + sqR );
+   auto w   = ( sqL*wL + sqR*wR + ( UsR[6] - UsL[6] )*sgn )/( sqL + sqR );
+   auto by  = ( sqL*UsR[5] + sqR*UsL[5] + sqL*sqR*( vR - vL )*sgn )/( sqL + sqR );
+   auto bz  = ( sqL*UsR[6] + sqR*UsL[6] + sqL*sqR*( wR - wL )*sgn )/( sqL + sqR );
+   auto ubss = SM*bn + v*by + w*bz;
+
+   double Uss[PRB_DIM];
+   if( SM >= 0.0 ){
+      auto ubs = SM*bn + vL*UsL[5] + wL*UsL[6];
+      Uss[0] = UsL[0];
+      Uss[7] = UsL[7] - sqL*( ubs - ubss )*sgn;
+   } else {
+      auto ubs = SM*bn + vR*UsR[5] + wR*UsR[6];
+      Uss[0] = UsR[0];
+      Uss[7] = UsR[7] + sqR*( ubs - ubss )*sgn;
+   }
+   Uss[1] = Uss[0]*SM;
+   Uss[2] = Uss[0]*v;
+   Uss[3] = Uss[0]*w;
+   Uss[4] = bn;
+   Uss[5] = by;
+   Uss[6] = bz;
+
+   // flux of the region of the face, eq. (65)
+   if( SM >= 0.0 ){
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         F_[k] = FL[k] + SL*( UsL[k] - UL[k] ) + SLs*( Uss[k] - UsL[k] );
+   } else {
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         F_[k] = FR[k] + SR*( UsR[k] - UR[k] ) + SRs*( Uss[k] - UsR[k] );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void SpatialMethodHLLD::getNumericalFluxG
+   ( double        WL[PRB_DIM]
+   , double        WR[PRB_DIM]
+   , double        G_[PRB_DIM]
+   , double       &maxWaveSpeed
+   , bool         &fallback
+) const {
+   // invert x and y axis
+   std::swap( WL[1], WL[2] ); std::swap( WL[4], WL[5] );
+   std::swap( WR[1], WR[2] ); std::swap( WR[4], WR[5] );
+
+   // find flux for inverted x and y
+   getNumericalFluxF( WL, WR, G_, maxWaveSpeed, fallback );
+
+   // return found flux to proper axes
+   std::swap( G_[1], G_[2] ); std::swap( G_[4], G_[5] );
+}
@@ -0,0 +1,84 @@
+#ifndef SPATIALMETHODHLLD_HPP
+#define SPATIALMETHODHLLD_HPP
+
+#include "spatialintegrationmethod.hpp"
+
+// Finite volume method with the HLLD approximate Riemann solver; see T. Miyoshi and K. Kusano,
+// "A multi-state HLL approximate Riemann solver for ideal magnetohydrodynamics", J. Comput.
+// Phys. 208, pp.315-344, 2005.
+//
+// The primitive variables (rho, u, v, w, bx, by, bz, p) are reconstructed on both sides of each
+// face, linearly with minmod-limited slopes, so the face values stay between the neighbouring
+// point values and density and pressure stay positive. The normal magnetic field of the face is
+// the average of both sides. Where the HLLD intermediate states are not physical (negative
+// density or pressure), the HLL flux of the same outer wave speeds is used instead. No
+// eigenvectors are needed
+class SpatialMethodHLLD : public SpatialIntegrationMethod
+{
+   public:
+      explicit SpatialMethodHLLD( size_t       nx
+                                , size_t       ny
+                                , size_t       bufferWidth
+                                , double       dx
+                                , double       dy
+                                , t_boundary   boundary
+                                , double       gamma
+                                );
+      virtual ~SpatialMethodHLLD();
+
+      t_status integrate( t_matrices      U
+                        , t_matrices      UL
+                        , borderVectors   borderFlux
+                        , double         &dtIdeal
+                        ) override;
+
+      static size_t requiredBufferWidth();
+
+      bool setOneDimensional( bool oneDimensional
+                            ) override;
+
+      void printStatistics( std::ostream &out
+                          ) const override;
+
+   protected:
+      void distributeMemory() override;
+
+   private:
+      static const size_t minimumBufferWidth = 2;
+
+      t_matrices W;   // primitive variables
+      t_matrices F_;  // numerical flux F
+      t_matrices G_;  // numerical flux G
+
+      // fluxes computed and HLL fallbacks over all integrations
+      size_t fluxesTotal      = 0;
+      size_t fluxesFallback   = 0;
+      bool   shownPressureWarning = false;
+
+      // Conserved variables U and flux F in x-direction of the primitive state W, with the
+      // normal magnetic field bn instead of bx
+      void getStateFlux( const double  W[PRB_DIM]
+                       , double        bn
+                       , double        U[PRB_DIM]
+                       , double        F[PRB_DIM] ) const;
+
+      // Fast magnetosonic speed in x-direction of the primitive state W with normal field bn
+      double getFastSpeed( const double  W[PRB_DIM]
+                         , double        bn ) const;
+
+      // HLLD flux F_ between the primitive states WL (left) and WR (right); maxWaveSpeed is the
+      // largest outer wave speed, fallback is set if the HLL flux was used instead
+      void getNumericalFluxF( const double  WL[PRB_DIM]
+                            , const double  WR[PRB_DIM]
+                            , double        F_[PRB_DIM]
+                            , double       &maxWaveSpeed
+                            , bool         &fallback ) const;
+      // Same for the flux G between WL (down) and WR (up)
+      void getNumericalFluxG( double        WL[PRB_DIM]
+                            , double        WR[PRB_DIM]
+                            , double        G_[PRB_DIM]
+                            , double       &maxWaveSpeed
+                            , bool         &fallback ) const;
+};
+
+#endif // SPATIALMETHODHLLD_HPP
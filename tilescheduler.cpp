@@ -0,0 +1,493 @@
+#include "tilescheduler.hpp"
+
+#include <cstdint>
+
+#if defined(USE_THREADS) && defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif // USE_THREADS && __linux__
+
+namespace {
+   // Without thread support everything runs on the calling thread
+   size_t supportedThreadCount
+      ( size_t requested
+   ){
+   #ifdef USE_THREADS
+      return requested > 0 ? requested : 1;
+   #else
+      (void)requested;
+      return 1;
+   #endif // USE_THREADS
+   }
+
+   double secondsSince
+      ( std::chrono::steady_clock::time_point start
+   ){
+      return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TileScheduler::TileScheduler
+   ( size_t threadCount
+   , size_t tileSize
+)
+   : threadCount{ supportedThreadCount( threadCount ) }
+   , tileSize{ tileSize > 0 ? tileSize : 1 }
+   , stats( this->threadCount )
+   , threadCpus( this->threadCount, -1 )
+   , loopCount{ 0 }
+#ifdef USE_THREADS
+   , deques{ new t_tileDeque[this->threadCount] }
+   , currentTask{ nullptr }
+   , currentStealing{ true }
+   , failed{ false }
+   , generation{ 0 }
+   , activeWorkers{ 0 }
+   , stopping{ false }
+#endif // USE_THREADS
+{
+   resetStatistics();
+
+#ifdef USE_THREADS
+   for( auto t = size_t{0}; t < this->threadCount; t++ ){
+      deques[t].range.store( packRange( 0, 0 ) );
+   }
+   // thread 0 is the caller of forTiles
+   for( auto t = size_t{1}; t < this->threadCount; t++ ){
+      workers.emplace_back( &TileScheduler::workerLoop, this, t );
+   }
+#endif // USE_THREADS
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TileScheduler::~TileScheduler
+   (
+){
+#ifdef USE_THREADS
+   {
+      std::unique_lock<std::mutex> guard( lock );
+      stopping = true;
+   }
+   wakeUp.notify_all();
+   for( auto &worker: workers ){
+      worker.join();
+   }
+#endif // USE_THREADS
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t TileScheduler::getThreadCount
+   (
+) const {
+   return threadCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t TileScheduler::getTileSize
+   (
+) const {
+   return tileSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t TileScheduler::getTileCount
+   ( size_t first
+   , size_t last
+) const {
+   if( first >= last ) return 0;
+   return ( last - first + tileSize - 1 ) / tileSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileScheduler::forTiles
+   ( size_t             first
+   , size_t             last
+   , const t_tileTask  &task
+){
+   runTileCount( getTileCount( first, last ), [&]( size_t tile, size_t thread ){
+      auto tileFirst = first + tile*tileSize;
+      auto tileLast  = std::min( tileFirst + tileSize, last );
+      task( tileFirst, tileLast, thread );
+   } );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileScheduler::run
+   ( const TileGraph &graph
+){
+   std::vector<size_t> levelNodes;
+   std::vector<size_t> tileOffsets;
+
+   for( auto level = size_t{0}; level < graph.levelCount; level++ ){
+      // collect the tasks of this level, with the first tile number of each
+      levelNodes.clear();
+      tileOffsets.clear();
+      auto tileCount = size_t{0};
+      for( auto n = size_t{0}; n < graph.nodes.size(); n++ ){
+         if( graph.nodes[n].level == level ){
+            levelNodes.push_back( n );
+            tileOffsets.push_back( tileCount );
+            tileCount += getTileCount( graph.nodes[n].first, graph.nodes[n].last );
+         }
+      }
+
+      runTileCount( tileCount, [&]( size_t tile, size_t thread ){
+         auto index = size_t( std::upper_bound( tileOffsets.begin(), tileOffsets.end(), tile ) - tileOffsets.begin() ) - 1;
+         auto &node = graph.nodes[levelNodes[index]];
+         auto tileFirst = node.first + ( tile - tileOffsets[index] )*tileSize;
+         auto tileLast  = std::min( tileFirst + tileSize, node.last );
+         node.task( tileFirst, tileLast, thread );
+      } );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TileScheduler::pinThreads
+   ( const std::vector<int> &cpus
+){
+#if defined(USE_THREADS) && defined(__linux__)
+   auto success = true;
+   for( auto t = size_t{0}; t < threadCount; t++ ){
+      auto cpu = cpus.empty() ? int(t) : cpus[t%cpus.size()];
+      cpu_set_t cpuSet;
+      CPU_ZERO( &cpuSet );
+      CPU_SET( cpu, &cpuSet );
+
+      auto handle = t == 0 ? pthread_self() : workers[t-1].native_handle();
+      if( pthread_setaffinity_np( handle, sizeof(cpuSet), &cpuSet ) == 0 ){
+         threadCpus[t] = cpu;
+      } else {
+         success = false;
+      }
+   }
+   return success;
+#else
+   (void)cpus;
+   return false;
+#endif // USE_THREADS && __linux__
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileScheduler::distribute
+   ( t_matrices &M
+   , size_t      n
+   , size_t      sizeX
+   , size_t      sizeY
+){
+   if( threadCount == 1 ) return;
+
+   // pages of a new allocation are only placed when first written
+   auto distributed = createMatrices( n, sizeX, sizeY );
+   runTileCount( getTileCount( 0, sizeX ), [&]( size_t tile, size_t /*thread*/ ){
+      auto tileFirst = tile*tileSize;
+      auto tileLast  = std::min( tileFirst + tileSize, sizeX );
+      for( auto k = size_t{0}; k < n; k++ ){
+         for( auto i = tileFirst; i < tileLast; i++ ){
+            std::copy( M[k][i], M[k][i] + sizeY, distributed[k][i] );
+         }
+      }
+   }, false );
+
+   freeMatrices( M );
+   M = distributed;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileScheduler::runTileCount
+   ( size_t              tileCount
+   , const t_indexTask  &task
+   , bool                allowStealing
+){
+   if( tileCount == 0 ) return;
+
+   auto start = std::chrono::steady_clock::now();
+   loopCount++;
+
+#ifdef USE_THREADS
+   if( threadCount > 1 && tileCount > 1 ){
+      currentTask     = &task;
+      currentStealing = allowStealing;
+      failed          = false;
+      failure      = nullptr;
+
+      // deal out the tiles in contiguous blocks
+      for( auto t = size_t{0}; t < threadCount; t++ ){
+         deques[t].range.store( packRange( tileCount*t/threadCount, tileCount*(t+1)/threadCount )
+                              , std::memory_order_relaxed );
+         deques[t].loopBusy   = 0.0;
+         deques[t].loopTiles  = 0;
+         deques[t].loopStolen = 0;
+      }
+
+      // wake up the workers and join in
+      {
+         std::unique_lock<std::mutex> guard( lock );
+         activeWorkers = threadCount-1;
+         generation++;
+      }
+      wakeUp.notify_all();
+      runTiles( 0 );
+
+      // wait until every worker has left the loop
+      {
+         std::unique_lock<std::mutex> guard( lock );
+         allDone.wait( guard, [this]{ return activeWorkers == 0; } );
+      }
+
+      auto loopTime = secondsSince( start );
+      for( auto t = size_t{0}; t < threadCount; t++ ){
+         stats[t].busy   += deques[t].loopBusy;
+         stats[t].idle   += loopTime - deques[t].loopBusy;
+         stats[t].tiles  += deques[t].loopTiles;
+         stats[t].stolen += deques[t].loopStolen;
+      }
+
+      currentTask = nullptr;
+      if( failure ){
+         std::rethrow_exception( failure );
+      }
+      return;
+   }
+#endif // USE_THREADS
+
+   // serial execution on the calling thread
+   for( auto tile = size_t{0}; tile < tileCount; tile++ ){
+      task( tile, 0 );
+   }
+
+   auto loopTime = secondsSince( start );
+   stats[0].busy  += loopTime;
+   stats[0].tiles += tileCount;
+   for( auto t = size_t{1}; t < threadCount; t++ ){
+      stats[t].idle += loopTime;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileScheduler::resetStatistics
+   (
+){
+   for( auto &s: stats ){
+      s = t_threadStats{ 0.0, 0.0, 0, 0 };
+   }
+   loopCount = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileScheduler::printStatistics
+   ( std::ostream &out
+) const {
+   out << " - Tile scheduler     : " << threadCount << " thread(s), tile size " << tileSize
+       << ", " << loopCount << " tiled loops\n";
+   for( auto t = size_t{0}; t < threadCount; t++ ){
+      auto total = stats[t].busy + stats[t].idle;
+      out << "   * thread " << t << ": busy " << stats[t].busy << " s, idle " << stats[t].idle << " s ("
+          << ( total > 0.0 ? 100.0*stats[t].busy/total : 0.0 ) << "% busy), "
+          << stats[t].tiles << " tiles, " << stats[t].stolen << " stolen";
+      if( threadCpus[t] >= 0 ){
+         out << ", cpu " << threadCpus[t];
+      }
+      out << "\n";
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TileGraph::t_node TileGraph::addTask
+   ( size_t                              first
+   , size_t                              last
+   , const TileScheduler::t_tileTask    &task
+   , const std::vector<t_node>          &dependencies
+){
+   auto level = size_t{0};
+   for( auto dependency: dependencies ){
+      level = std::max( level, nodes.at( dependency ).level + 1 );
+   }
+
+   nodes.push_back( t_graphNode{ first, last, task, level } );
+   levelCount = std::max( levelCount, level + 1 );
+
+   return nodes.size() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TileResults::TileResults
+   ( size_t threadCount
+)
+   : maxValues( threadCount, 0.0 )
+   , errorIndices( threadCount, SIZE_MAX )
+   , errors( threadCount, t_status{ false, ReturnStatus::OK, std::string{} } )
+   , anyError{ false }
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileResults::updateMax
+   ( size_t thread
+   , double value
+){
+   if( value > maxValues[thread] ){
+      maxValues[thread] = value;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileResults::setError
+   ( size_t          thread
+   , size_t          index
+   , const t_status &status
+){
+   if( index < errorIndices[thread] ){
+      errorIndices[thread] = index;
+      errors[thread]       = status;
+   }
+   anyError = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TileResults::failed
+   (
+) const {
+   return anyError;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double TileResults::getMax
+   (
+) const {
+   return *std::max_element( maxValues.begin(), maxValues.end() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status TileResults::getError
+   (
+) const {
+   auto first = std::min_element( errorIndices.begin(), errorIndices.end() ) - errorIndices.begin();
+   return errors[first];
+}
+
+#ifdef USE_THREADS
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+uint64_t TileScheduler::packRange
+   ( uint64_t begin
+   , uint64_t end
+){
+   return ( begin << 32 ) | end;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TileScheduler::popOwn
+   ( size_t  thread
+   , size_t &tile
+){
+   auto &range = deques[thread].range;
+   auto packed = range.load( std::memory_order_acquire );
+   while( true ){
+      auto begin = packed >> 32;
+      auto end   = packed & 0xffffffffu;
+      if( begin >= end ){
+         return false;
+      }
+      // owner takes from the front
+      if( range.compare_exchange_weak( packed, packRange( begin+1, end ), std::memory_order_acq_rel ) ){
+         tile = begin;
+         return true;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TileScheduler::steal
+   ( size_t  thread
+   , size_t &tile
+){
+   for( auto offset = size_t{1}; offset < threadCount; offset++ ){
+      auto &range = deques[(thread+offset)%threadCount].range;
+      auto packed = range.load( std::memory_order_acquire );
+      while( true ){
+         auto begin = packed >> 32;
+         auto end   = packed & 0xffffffffu;
+         if( begin >= end ){
+            break;
+         }
+         // thieves take from the back
+         if( range.compare_exchange_weak( packed, packRange( begin, end-1 ), std::memory_order_acq_rel ) ){
+            tile = end-1;
+            return true;
+         }
+      }
+   }
+
+   return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileScheduler::workerLoop
+   ( size_t thread
+){
+   auto seenGeneration = size_t{0};
+
+   while( true ){
+      {
+         std::unique_lock<std::mutex> guard( lock );
+         wakeUp.wait( guard, [this, seenGeneration]{ return stopping || generation != seenGeneration; } );
+         if( stopping ){
+            return;
+         }
+         seenGeneration = generation;
+      }
+
+      runTiles( thread );
+
+      {
+         std::unique_lock<std::mutex> guard( lock );
+         if( --activeWorkers == 0 ){
+            allDone.notify_one();
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileScheduler::runTiles
+   ( size_t thread
+){
+   auto tile = size_t{};
+
+   // blocks only shrink during a loop, so once nothing is left to pop or steal, the loop is done
+   while( !failed.load( std::memory_order_relaxed ) ){
+      if( popOwn( thread, tile ) ){
+         runTile( tile, thread, false );
+      } else if( currentStealing && steal( thread, tile ) ){
+         runTile( tile, thread, true );
+      } else {
+         break;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TileScheduler::runTile
+   ( size_t tile
+   , size_t thread
+   , bool   stolen
+){
+   auto start = std::chrono::steady_clock::now();
+
+   try {
+      (*currentTask)( tile, thread );
+   } catch( ... ) {
+      std::unique_lock<std::mutex> guard( failureLock );
+      if( !failure ){
+         failure = std::current_exception();
+      }
+      failed = true;
+   }
+
+   deques[thread].loopBusy += secondsSince( start );
+   deques[thread].loopTiles++;
+   if( stolen ){
+      deques[thread].loopStolen++;
+   }
+}
+#endif // USE_THREADS
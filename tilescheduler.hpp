@@ -0,0 +1,214 @@
+#ifndef TILESCHEDULER_HPP
+#define TILESCHEDULER_HPP
+
+#include "mhd2d.hpp"
+
+#include <functional>
+#include <memory>
+
+#ifdef USE_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif // USE_THREADS
+
+// Work-stealing scheduler for tiled loops over the simulation grid.
+//
+// A range of indices is cut into tiles of tileSize indices. At the start of each
+// loop the tiles are dealt out to the threads in contiguous blocks (the same split
+// a static OpenMP schedule would make), and each thread works through its own
+// block from the front. A thread that runs out of tiles steals single tiles from
+// the back of another thread's block, so expensive regions of the grid (open and
+// Dirichlet boundaries, the current sheet, ...) do not leave the other cores idle.
+//
+// Each block is stored as one packed [begin,end) word; both the owner and the
+// thieves advance it with a compare-and-swap, so stealing is lock-free.
+//
+// Without USE_THREADS, or with a single thread, tiles are run in order on the
+// calling thread.
+class TileGraph;
+class TileScheduler
+{
+   public:
+      // task( first, last, thread ): process indices [first,last) on given thread
+      typedef std::function<void( size_t, size_t, size_t )> t_tileTask;
+
+      explicit TileScheduler( size_t threadCount
+                            , size_t tileSize
+                            );
+      virtual ~TileScheduler();
+
+      size_t getThreadCount() const;
+      size_t getTileSize() const;
+
+      // Number of tiles the range [first,last) is split into
+      size_t getTileCount( size_t first
+                         , size_t last
+                         ) const;
+
+      // Run task on all tiles of [first,last); returns when all tiles are done
+      void forTiles( size_t             first
+                   , size_t             last
+                   , const t_tileTask  &task
+                   );
+
+      // Run all tasks of graph; returns when all tasks are done
+      void run( const TileGraph &graph );
+
+      // Pin thread t to CPU cpus[t % cpus.size()], or to CPU t if cpus is empty;
+      // thread 0 is the calling thread. Returns false if pinning is not supported or failed
+      bool pinThreads( const std::vector<int> &cpus );
+
+      // Move the n x sizeX x sizeY matrices M to memory first touched by the threads that
+      // process their columns (each thread copies its own block of tiles of [0,sizeX)),
+      // so that pages are placed on the NUMA node of that thread; no-op for a single thread
+      void distribute( t_matrices &M
+                     , size_t      n
+                     , size_t      sizeX
+                     , size_t      sizeY
+                     );
+
+      // Per-thread busy/idle time, tiles processed and tiles stolen
+      void resetStatistics();
+      void printStatistics( std::ostream &out ) const;
+
+   protected:
+
+   private:
+      // task( tile, thread ): process tile number tile on given thread
+      typedef std::function<void( size_t, size_t )> t_indexTask;
+
+      struct t_threadStats {
+         double busy;
+         double idle;
+         size_t tiles;
+         size_t stolen;
+      };
+
+      const size_t threadCount;
+      const size_t tileSize;
+
+      std::vector<t_threadStats> stats;
+      std::vector<int>           threadCpus;
+      size_t loopCount;
+
+      // Run task on tiles [0,tileCount); without stealing, each thread processes
+      // exactly its own block of tiles
+      void runTileCount( size_t              tileCount
+                       , const t_indexTask  &task
+                       , bool                allowStealing = true
+                       );
+
+#ifdef USE_THREADS
+      // Tile block owned by one thread, with the thread's timing for the current loop;
+      // padded to a cache line to avoid false sharing
+      struct t_tileDeque {
+         std::atomic<uint64_t> range;
+         double loopBusy;
+         size_t loopTiles;
+         size_t loopStolen;
+         char padding[64-sizeof(std::atomic<uint64_t>)-sizeof(double)-2*sizeof(size_t)];
+      };
+
+      std::unique_ptr<t_tileDeque[]> deques;
+      std::vector<std::thread>       workers;
+
+      // current loop
+      const t_indexTask *currentTask;
+      bool               currentStealing;
+      std::atomic<bool>  failed;
+      std::exception_ptr failure;
+      std::mutex         failureLock;
+
+      // worker synchronization
+      std::mutex              lock;
+      std::condition_variable wakeUp;
+      std::condition_variable allDone;
+      size_t                  generation;
+      size_t                  activeWorkers;
+      bool                    stopping;
+
+      static uint64_t packRange( uint64_t begin
+                               , uint64_t end );
+      bool popOwn( size_t  thread
+                 , size_t &tile );
+      bool steal( size_t  thread
+                , size_t &tile );
+
+      void workerLoop( size_t thread );
+      void runTiles( size_t thread );
+      void runTile( size_t tile
+                  , size_t thread
+                  , bool   stolen );
+#endif // USE_THREADS
+};
+
+// Tiled tasks with dependencies between them, e.g. the phases of a spatial integration step.
+//
+// A task may only depend on tasks added before it. Tasks are grouped into levels, each
+// one level above its latest dependency; the scheduler runs the levels in order, and the
+// tiles of all tasks on the same level are put into one pool, so independent phases (and
+// single-tile tasks such as boundary edges) are processed at the same time.
+class TileGraph
+{
+   public:
+      typedef size_t t_node;
+
+      t_node addTask( size_t                              first
+                    , size_t                              last
+                    , const TileScheduler::t_tileTask    &task
+                    , const std::vector<t_node>          &dependencies = {}
+                    );
+
+   private:
+      friend class TileScheduler;
+
+      struct t_graphNode {
+         size_t                     first;
+         size_t                     last;
+         TileScheduler::t_tileTask  task;
+         size_t                     level;
+      };
+
+      std::vector<t_graphNode> nodes;
+      size_t                   levelCount = 0;
+};
+
+// Per-thread results of a tiled loop: the maximum of a tracked value, and the error
+// with the lowest grid index among the errors found (so a serial run reports the same
+// error as the original sequential loops)
+class TileResults
+{
+   public:
+      explicit TileResults( size_t threadCount
+                          );
+
+      void updateMax( size_t thread
+                    , double value
+                    );
+      void setError( size_t          thread
+                   , size_t          index
+                   , const t_status &status
+                   );
+
+      // true once any tile has reported an error; tiles may use it to stop early
+      bool failed() const;
+
+      double   getMax() const;
+      t_status getError() const;
+
+   private:
+      std::vector<double>   maxValues;
+      std::vector<size_t>   errorIndices;
+      std::vector<t_status> errors;
+#ifdef USE_THREADS
+      std::atomic<bool>     anyError;
+#else
+      bool                  anyError;
+#endif // USE_THREADS
+};
+
+#endif // TILESCHEDULER_HPP
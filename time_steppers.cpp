@@ -68,6 +68,10 @@ t_status stepRK3TVD
 
       // RK3, first step - calculate finite differences
       switch( params.scheme ){
+      case IntegrationMethod::ENO_LF_Hybrid: // (not in old style stepping)
+      case IntegrationMethod::ENO_LF_Componentwise: // (not in old style stepping)
+      case IntegrationMethod::WENO5_LF: // (not in old style stepping)
+      case IntegrationMethod::HLLD: // (not in old style stepping)
       case IntegrationMethod::Undefined:
          ERROUT << "ERROR: stepRK3TVD: Spatial integration method unknown." << LF;
          return { true, ReturnStatus::ErrorWrongParameter, "spatial integration method unknown\n! stepRK3TVD: first step" };
@@ -108,6 +112,10 @@ t_status stepRK3TVD
 
       // RK3, second step - calculate finite differences
       switch( params.scheme ){
+      case IntegrationMethod::ENO_LF_Hybrid: // (not in old style stepping)
+      case IntegrationMethod::ENO_LF_Componentwise: // (not in old style stepping)
+      case IntegrationMethod::WENO5_LF: // (not in old style stepping)
+      case IntegrationMethod::HLLD: // (not in old style stepping)
       case IntegrationMethod::Undefined:
          ERROUT << "ERROR: stepRK3TVD: Spatial integration method unknown." << LF;
          return { true, ReturnStatus::ErrorWrongParameter, "spatial integration method unknown\n! stepRK3TVD: second step" };
@@ -150,6 +158,10 @@ t_status stepRK3TVD
 
       // RK3, final step - calculate finite differences
       switch( params.scheme ){
+      case IntegrationMethod::ENO_LF_Hybrid: // (not in old style stepping)
+      case IntegrationMethod::ENO_LF_Componentwise: // (not in old style stepping)
+      case IntegrationMethod::WENO5_LF: // (not in old style stepping)
+      case IntegrationMethod::HLLD: // (not in old style stepping)
       case IntegrationMethod::Undefined:
          ERROUT << "ERROR: stepRK3TVD: Spatial integration method unknown." << LF;
          return { true, ReturnStatus::ErrorWrongParameter, "spatial integration method unknown\n! stepRK3TVD: last step" };
@@ -214,6 +226,10 @@ t_status stepEuler
    t_status retval;
    // Run the method
    switch( params.scheme ){
+   case IntegrationMethod::ENO_LF_Hybrid: // (not in old style stepping)
+   case IntegrationMethod::ENO_LF_Componentwise: // (not in old style stepping)
+   case IntegrationMethod::WENO5_LF: // (not in old style stepping)
+   case IntegrationMethod::HLLD: // (not in old style stepping)
    case IntegrationMethod::Undefined:
       ERROUT << "ERROR: stepEuler: Spatial integration method unknown." << LF;
          return { true, ReturnStatus::ErrorWrongParameter, "spatial integration method unknown\n! stepEuler" };
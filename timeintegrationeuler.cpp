@@ -22,6 +22,13 @@ TimeIntegrationEuler::~TimeIntegrationEuler
    freeMatrices( UL );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationEuler::distributeMemory
+   (
+){
+   scheduler->distribute( UL, PRB_DIM, nxTotal, nyTotal );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 t_status TimeIntegrationEuler::step
    ( t_matrices      U
@@ -44,17 +51,19 @@ t_status TimeIntegrationEuler::step
    }
 
    // Update time step, check for errors
-   retval = updateDt( dt, dtIdeal );
+   retval = predictDt( dt, dtIdeal );
    if( retval.isError ){
       retval.message += "\n! TimeIntegrationEuler::step: update time step";
       return retval;
    }
 
    // Update return variables
-   for( auto k = size_t{0}; k < PRB_DIM; k++ )
-      for( auto i = nxFirst; i < nxLast; i++ )
-         for( auto j = nyFirst; j < nyLast; j++ )
-            U[k][i][j] = U[k][i][j] + dt*UL[k][i][j];
+   scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         for( auto i = iFirst; i < iLast; i++ )
+            for( auto j = nyFirst; j < nyLast; j++ )
+               U[k][i][j] = U[k][i][j] + dt*UL[k][i][j];
+   } );
    dtCurrent = dt;
    method->getCharacteristicsX( cx, LUx );
    method->getCharacteristicsY( cy, LUy );
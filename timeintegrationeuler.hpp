@@ -26,6 +26,7 @@ class TimeIntegrationEuler : public TimeIntegrationMethod
                    ) override;
 
    protected:
+      void distributeMemory() override;
 
    private:
       t_matrices UL;
@@ -19,9 +19,21 @@ TimeIntegrationMethod::TimeIntegrationMethod
    , dtMax{ dtMax }
    , cflNumber{ cflNumber }
    , variableTime{ cflNumber != 0.0 }
+   , sspCoefficient{ 1.0 }
+   , dtControl{ TimeStepControl::Halving }
+   , dtIdealPrevious{ 0.0 }
+   , dtIdealStageMin{ 0.0 }
+   , rejectedSteps{ 0 }
+   , errorControl{ false }
+   , errorRelativeTolerance{ 0.0 }
+   , errorAbsoluteTolerance{ 0.0 }
+   , dtError{ dtMax }
+   , errorPrevious{ 1.0 }
+   , errorRejected{ false }
+   , errorRejectedSteps{ 0 }
    , method{ std::move( method ) }
 {
-   //ctor
+   scheduler = std::make_shared<TileScheduler>( 1, nxTotal );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +43,73 @@ TimeIntegrationMethod::~TimeIntegrationMethod
    //dtor
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationMethod::distributeMemory
+   (
+){
+   // no scratch arrays
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationMethod::setScheduler
+   ( std::shared_ptr<TileScheduler> scheduler
+){
+   this->scheduler = scheduler;
+   distributeMemory();
+   method->setScheduler( scheduler );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationMethod::setTimeStepControl
+   ( TimeStepControl control
+){
+   dtControl = control;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TimeIntegrationMethod::setErrorControl
+   ( double relativeTolerance
+   , double absoluteTolerance
+){
+   if( !hasErrorEstimate() ){
+      return false;
+   }
+
+   errorControl = true;
+   errorRelativeTolerance = relativeTolerance;
+   errorAbsoluteTolerance = absoluteTolerance;
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t TimeIntegrationMethod::getRejectedSteps
+   (
+) const {
+   return rejectedSteps;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t TimeIntegrationMethod::getErrorRejectedSteps
+   (
+) const {
+   return errorRejectedSteps;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationMethod::printStatistics
+   ( std::ostream &out
+) const {
+   method->printStatistics( out );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TimeIntegrationMethod::hasErrorEstimate
+   (
+) const {
+   return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 t_status TimeIntegrationMethod::updateDt
    ( double   &dtCurrent
@@ -40,10 +119,17 @@ t_status TimeIntegrationMethod::updateDt
       return { false, ReturnStatus::NoChange, "" };
    }
 
-   auto dt = dtCurrent;
+   auto dt  = dtCurrent;
+   auto cfl = sspCoefficient*cflNumber;
+
+   if( dtControl == TimeStepControl::Continuous ){
+      // largest dt allowed by the CFL condition
+      dt = cfl*dtIdeal;
+      dtIdealStageMin = std::min( dtIdealStageMin, dtIdeal );
+   }
 
    // resize dt to fit between 0.5*cfl and cfl
-   while( dt < 0.5*cflNumber*dtIdeal ){
+   while( dt < 0.5*cfl*dtIdeal ){
       dt *= 2.0;
 
       #ifdef DEBUG_DT_UPDATE
@@ -51,7 +137,7 @@ t_status TimeIntegrationMethod::updateDt
       #endif // DEBUG_DT_UPDATE
    }
 
-   while( dt > cflNumber*dtIdeal ){
+   while( dt > cfl*dtIdeal ){
       dt /= 2.0;
 
       #ifdef DEBUG_DT_UPDATE
@@ -88,3 +174,103 @@ t_status TimeIntegrationMethod::updateDt
       return { false, ReturnStatus::Updated, "" };
    }
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status TimeIntegrationMethod::predictDt
+   ( double   &dtCurrent
+   , double    dtIdeal
+){
+   if( !variableTime || dtControl != TimeStepControl::Continuous ){
+      return updateDt( dtCurrent, dtIdeal );
+   }
+
+   // If the wave speeds keep growing at the same rate, the ideal time step at the end of this
+   // step will be dtIdeal + rate*dt; choose dt so that it still satisfies the CFL condition,
+   // i.e. dt = cfl*( dtIdeal + rate*dt )
+   auto cfl = sspCoefficient*cflNumber;
+   auto dtTarget = dtIdeal;
+   if( dtIdealPrevious > 0.0 && dtCurrent > 0.0 ){
+      auto rate = ( dtIdeal - dtIdealPrevious )/dtCurrent;
+      if( rate < 0.0 ){
+         dtTarget = dtIdeal/( 1.0 - cfl*rate );
+      }
+
+      // the later stages of the previous step needed a smaller dt than its first stage; expect
+      // the same relative drop in this step
+      if( dtIdealStageMin < dtIdealPrevious ){
+         dtTarget = std::min( dtTarget, dtIdeal*dtIdealStageMin/dtIdealPrevious );
+      }
+   }
+
+   auto retval = updateDt( dtCurrent, dtTarget );
+
+   dtIdealPrevious = dtIdeal;
+   dtIdealStageMin = dtIdeal;
+
+   return retval;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TimeIntegrationMethod::rejectStep
+   ( double dtStage
+   , double dt
+){
+   auto limit = dtStage;
+   if( dtControl == TimeStepControl::Continuous ){
+      limit *= 1.0 + dtStageTolerance;
+   }
+
+   if( limit < dt ){
+      rejectedSteps++;
+      return true;
+   }
+
+   return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double TimeIntegrationMethod::scaledError
+   ( double e
+   , double U
+   , double UNew
+) const {
+   return std::abs( e )/( errorAbsoluteTolerance + errorRelativeTolerance*std::max( std::abs( U ), std::abs( UNew ) ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TimeIntegrationMethod::rejectStepError
+   ( double error
+   , double dt
+   , double errorOrder
+){
+   // PI step size controller (Gustafsson), which damps the oscillations of dt caused by the
+   // non-smooth ENO stencil selection; dt may not grow right after a rejected step
+   const auto safety    = 0.9;
+   const auto factorMin = 0.2;
+   const auto factorMax = 2.0;
+   const auto alpha     = 0.7/errorOrder;
+   const auto beta      = 0.4/errorOrder;
+
+   auto factor = factorMax;
+   if( error > 0.0 ){
+      factor = safety*std::pow( error, -alpha )*std::pow( errorPrevious, beta );
+      factor = std::min( factorMax, std::max( factorMin, factor ) );
+   }
+
+   if( error > 1.0 ){
+      dtError = std::min( dtMax, std::min( 1.0, factor )*dt );
+      errorRejected = true;
+      rejectedSteps++;
+      errorRejectedSteps++;
+      return true;
+   }
+
+   if( errorRejected ){
+      factor = std::min( 1.0, factor );
+   }
+   dtError = std::min( dtMax, factor*dt );
+   errorPrevious = std::max( error, 1.0e-4 );
+   errorRejected = false;
+
+   return false;
+}
@@ -26,6 +26,27 @@ class TimeIntegrationMethod
                            , double         &dtCurrent
                            ) = 0;
 
+      // Set the scheduler for tiled grid loops; also passed to the spatial method
+      void setScheduler( std::shared_ptr<TileScheduler> scheduler );
+
+      // Set how the time step size is chosen in variable time stepping mode
+      void setTimeStepControl( TimeStepControl control );
+
+      // Limit dt so that the error estimated from an embedded method stays below
+      // absoluteTolerance + relativeTolerance*|U|; returns false if the method has no error estimate
+      bool setErrorControl( double relativeTolerance
+                          , double absoluteTolerance
+                          );
+
+      // Number of time steps that had to be redone with a smaller time step, in total
+      // and because of the error estimate
+      size_t getRejectedSteps() const;
+      size_t getErrorRejectedSteps() const;
+
+      // Method-specific statistics (and those of the spatial method), printed at the end of
+      // the simulation
+      virtual void printStatistics( std::ostream &out ) const;
+
    protected:
       const size_t   nxProblem;
       const size_t   nyProblem;
@@ -43,12 +64,68 @@ class TimeIntegrationMethod
       double   cflNumber;
       bool     variableTime;
 
+      // SSP coefficient of the method: each stage is an Euler step of at most dt/sspCoefficient,
+      // so the CFL condition becomes dt <= sspCoefficient*cflNumber*dtIdeal
+      double   sspCoefficient;
+
+      TimeStepControl   dtControl;
+      double            dtIdealPrevious;
+      double            dtIdealStageMin;
+      size_t            rejectedSteps;
+
+      // error control: tolerances and the time step proposed for the next step
+      bool              errorControl;
+      double            errorRelativeTolerance;
+      double            errorAbsoluteTolerance;
+      double            dtError;
+      double            errorPrevious;
+      bool              errorRejected;
+      size_t            errorRejectedSteps;
+
       std::unique_ptr<SpatialIntegrationMethod> method;
+      std::shared_ptr<TileScheduler>            scheduler;
+
+      // Move scratch arrays to memory first touched by the threads of the scheduler
+      virtual void distributeMemory();
 
       virtual t_status updateDt( double  &dtCurrent
                                , double   dtIdeal
                                );
 
+      // Time step for the first stage of a step, where dtCurrent is the previous time step;
+      // with continuous control, dt is lowered in advance if dtIdeal has been decreasing
+      // between steps, or within the stages of the previous step
+      t_status predictDt( double  &dtCurrent
+                        , double   dtIdeal
+                        );
+
+      // Check if the time step dt used for a step has to be rejected because a later stage
+      // requires dtStage; counts rejected steps. With continuous control, dt may exceed dtStage
+      // by a relative dtStageTolerance, so that round-off in dtIdeal does not reject steps
+      bool rejectStep( double dtStage
+                     , double dt
+                     );
+
+      static constexpr double dtStageTolerance = 1.0e-3;
+
+      // true if the step method provides an embedded error estimate
+      virtual bool hasErrorEstimate() const;
+
+      // Scaled error of a point, |e|/( atol + rtol*max(|U|,|UNew|) ); a step is accepted if the
+      // maximum over the grid is at most 1
+      double scaledError( double e
+                        , double U
+                        , double UNew
+                        ) const;
+
+      // Check if the time step dt has to be rejected because of the scaled error of the step;
+      // counts rejected steps, and sets dtError for the next attempt (or step) from the
+      // error of an embedded method of order errorOrder-1
+      bool rejectStepError( double error
+                          , double dt
+                          , double errorOrder
+                          );
+
    private:
 };
 
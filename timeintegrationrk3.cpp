@@ -12,9 +12,9 @@ TimeIntegrationRK3::TimeIntegrationRK3
 )
    : TimeIntegrationMethod{ nx, ny, bufferWidth, dtMin, dtMax, cflNumber, std::move( method ) }
 {
-   U1 = createMatrices( PRB_DIM, nxTotal, nyTotal );
-   U2 = createMatrices( PRB_DIM, nxTotal, nyTotal );
-   UL = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   U1      = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   UL      = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   ULStage = createMatrices( PRB_DIM, nxTotal, nyTotal );
 
    borderFlux1.left  = createVectors( PRB_DIM, nyTotal );
    borderFlux1.right = createVectors( PRB_DIM, nyTotal );
@@ -31,8 +31,8 @@ TimeIntegrationRK3::~TimeIntegrationRK3
    (
 ){
    freeMatrices( U1 );
-   freeMatrices( U2 );
    freeMatrices( UL );
+   freeMatrices( ULStage );
 
    freeVectors( borderFlux1.left  );
    freeVectors( borderFlux1.right );
@@ -44,6 +44,22 @@ TimeIntegrationRK3::~TimeIntegrationRK3
    freeVectors( borderFlux2.down  );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3::distributeMemory
+   (
+){
+   scheduler->distribute( U1,      PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( UL,      PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( ULStage, PRB_DIM, nxTotal, nyTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TimeIntegrationRK3::hasErrorEstimate
+   (
+) const {
+   return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 t_status TimeIntegrationRK3::step
    ( t_matrices      U
@@ -72,7 +88,7 @@ t_status TimeIntegrationRK3::step
    }
 
    // First step: update time step, check for errors
-   retval = updateDt( dtFirstStep, dtIdeal );
+   retval = predictDt( dtFirstStep, dtIdeal );
    if( retval.isError ){
       retval.message += "\n! TimeIntegrationRK3::step: (first) update time step";
       return retval;
@@ -80,15 +96,21 @@ t_status TimeIntegrationRK3::step
 
    while( !done ){
       dt = std::min({ dtFirstStep, dtSecondStep, dtFinalStep });
+      if( errorControl ){
+         dt = std::min( dt, dtError );
+         if( dt < dtMin ){
+            return { true, ReturnStatus::ErrorTimeUnderflow
+                   , std::string{} + "Error tolerance not satisfied!\n"
+                   + "Minimum time step = " + std::to_string(dtMin) + "\n"
+                   + "Target time step  = " + std::to_string(dt) + "\n"
+                   + "! TimeIntegrationRK3::step" };
+         }
+      }
 
-      // First step: update variables
-      for( auto k = size_t{0}; k < PRB_DIM; k++ )
-         for( auto i = nxFirst; i < nxLast; i++ )
-            for( auto j = nyFirst; j < nyLast; j++ )
-               U1[k][i][j] = U[k][i][j] + dt*UL[k][i][j];
-
+      // First step: update variables, U1 = U + dt*UL;
       // Second step: spatial integration, check for errors
-      retval = method->integrate( U1, UL, borderFlux1, dtIdeal );
+      auto firstStage = t_stageUpdate{ U, 1.0, nullptr, 0.0, UL, dt };
+      retval = method->integrateStage( firstStage, U1, ULStage, borderFlux1, dtIdeal );
       if( retval.isError ){
          retval.message += "\n! TimeIntegrationRK3::step: (second) spatial integration";
          return retval;
@@ -100,18 +122,14 @@ t_status TimeIntegrationRK3::step
          retval.message += "\n! TimeIntegrationRK3::step: (second) update time step";
          return retval;
       }
-      if( dtSecondStep < dt ){
+      if( rejectStep( dtSecondStep, dt ) ){
          continue;
       }
 
-      // Second step: update variables
-      for( auto k = size_t{0}; k < PRB_DIM; k++ )
-         for( auto i = nxFirst; i < nxLast; i++ )
-            for( auto j = nyFirst; j < nyLast; j++ )
-               U2[k][i][j] = (3.0/4.0)*U[k][i][j] + (1.0/4.0)*U1[k][i][j] + (1.0/4.0)*dt*UL[k][i][j];
-
+      // Second step: update variables in place, U1 = 3/4*U + 1/4*U1 + 1/4*dt*ULStage;
       // Final step: spatial integration, check for errors
-      retval = method->integrate( U2, UL, borderFlux2, dtIdeal );
+      auto secondStage = t_stageUpdate{ U, 3.0/4.0, U1, 1.0/4.0, ULStage, (1.0/4.0)*dt };
+      retval = method->integrateStage( secondStage, U1, ULStage, borderFlux2, dtIdeal );
       if( retval.isError ){
          retval.message += "\n! TimeIntegrationRK3::step: (last) spatial integration";
          return retval;
@@ -123,15 +141,39 @@ t_status TimeIntegrationRK3::step
          retval.message += "\n! TimeIntegrationRK3::step: (last) update time step";
          return retval;
       }
-      if( dtFinalStep < dt ){
+      if( rejectStep( dtFinalStep, dt ) ){
          continue;
       }
 
+      // Error control: compare the new state with the embedded second order solution
+      if( errorControl ){
+         TileResults errorResults{ scheduler->getThreadCount() };
+         scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+            auto error = double{0.0};
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               for( auto i = iFirst; i < iLast; i++ ){
+                  for( auto j = nyFirst; j < nyLast; j++ ){
+                     auto UNew = (1.0/3.0)*U[k][i][j] + (2.0/3.0)*U1[k][i][j] + (2.0/3.0)*dt*ULStage[k][i][j];
+                     auto UEmbedded = 2.0*U1[k][i][j] - U[k][i][j];
+                     error = std::max( error, scaledError( UNew - UEmbedded, U[k][i][j], UNew ) );
+                  }
+               }
+            }
+            errorResults.updateMax( thread, error );
+         } );
+
+         if( rejectStepError( errorResults.getMax(), dt, 3.0 ) ){
+            continue;
+         }
+      }
+
       // Final step: update variables
-      for( auto k = size_t{0}; k < PRB_DIM; k++ )
-         for( auto i = nxFirst; i < nxLast; i++ )
-            for( auto j = nyFirst; j < nyLast; j++ )
-               U[k][i][j] = (1.0/3.0)*U[k][i][j] + (2.0/3.0)*U2[k][i][j] + (2.0/3.0)*dt*UL[k][i][j];
+      scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            for( auto i = iFirst; i < iLast; i++ )
+               for( auto j = nyFirst; j < nyLast; j++ )
+                  U[k][i][j] = (1.0/3.0)*U[k][i][j] + (2.0/3.0)*U1[k][i][j] + (2.0/3.0)*dt*ULStage[k][i][j];
+      } );
 
       for( auto k = size_t{0}; k < PRB_DIM; k++ ){
          for( auto i = nxFirst; i < nxLast; i++ ){
@@ -26,11 +26,17 @@ class TimeIntegrationRK3 : public TimeIntegrationMethod
                    ) override;
 
    protected:
+      void distributeMemory() override;
+
+      // Embedded second order solution 2*U2 - U (Heun's method)
+      bool hasErrorEstimate() const override;
 
    private:
+      // Intermediate stages (the second stage is updated in place), the spatial derivative of
+      // the first stage, kept in case the time step is rejected, and of the later stages
       t_matrices U1;
-      t_matrices U2;
       t_matrices UL;
+      t_matrices ULStage;
 
       borderVectors borderFlux1;
       borderVectors borderFlux2;
@@ -0,0 +1,457 @@
+#include "timeintegrationrk3imex.hpp"
+
+constexpr double TimeIntegrationRK3Imex::imexCoefficient;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationRK3Imex::TimeIntegrationRK3Imex
+   ( size_t nx
+   , size_t ny
+   , size_t bufferWidth
+   , double dtMin
+   , double dtMax
+   , double cflNumber
+   , std::unique_ptr<SpatialIntegrationMethod> method
+   , t_boundary   boundary
+   , bool         mirrorBottom
+   , double       cflFactor
+   , double       tolerance
+   , size_t       maxIterations
+)
+   : TimeIntegrationMethod{ nx, ny, bufferWidth, dtMin, dtMax, cflFactor*cflNumber, std::move( method ) }
+   , boundary{ boundary }
+   , mirrorBottom{ mirrorBottom }
+   , tolerance{ tolerance }
+   , maxIterations{ maxIterations }
+{
+   U1         = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   UL         = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   ULImplicit = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   ULStage    = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   CG         = createMatrices( 3, nxTotal, nyTotal );
+   columnSums.assign( nxTotal, 0.0 );
+   weightX.assign( nyTotal, 0.0 );
+   weightY.assign( nyTotal, 0.0 );
+
+   borderFlux1.left  = createVectors( PRB_DIM, nyTotal );
+   borderFlux1.right = createVectors( PRB_DIM, nyTotal );
+   borderFlux1.up    = createVectors( PRB_DIM, nxTotal );
+   borderFlux1.down  = createVectors( PRB_DIM, nxTotal );
+   borderFlux2.left  = createVectors( PRB_DIM, nyTotal );
+   borderFlux2.right = createVectors( PRB_DIM, nyTotal );
+   borderFlux2.up    = createVectors( PRB_DIM, nxTotal );
+   borderFlux2.down  = createVectors( PRB_DIM, nxTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationRK3Imex::~TimeIntegrationRK3Imex
+   (
+){
+   freeMatrices( U1 );
+   freeMatrices( UL );
+   freeMatrices( ULImplicit );
+   freeMatrices( ULStage );
+   freeMatrices( CG );
+
+   freeVectors( borderFlux1.left  );
+   freeVectors( borderFlux1.right );
+   freeVectors( borderFlux1.up    );
+   freeVectors( borderFlux1.down  );
+   freeVectors( borderFlux2.left  );
+   freeVectors( borderFlux2.right );
+   freeVectors( borderFlux2.up    );
+   freeVectors( borderFlux2.down  );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Imex::distributeMemory
+   (
+){
+   scheduler->distribute( U1,         PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( UL,         PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( ULImplicit, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( ULStage,    PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( CG,         3,       nxTotal, nyTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool TimeIntegrationRK3Imex::hasErrorEstimate
+   (
+) const {
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Imex::printStatistics
+   ( std::ostream &out
+) const {
+   TimeIntegrationMethod::printStatistics( out );
+   if( solves > 0 ){
+      out << " - Implicit solves    : " << solves << " (per variable), " << double(iterations)/solves
+          << " conjugate gradient iterations each";
+      if( solvesNotConverged > 0 ){
+         out << ", " << solvesNotConverged << " not converged";
+      }
+      out << "\n";
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status TimeIntegrationRK3Imex::step
+   ( t_matrices      U
+   , t_matrices      cx
+   , t_matrices      cy
+   , t_matrices      LUx
+   , t_matrices      LUy
+   , borderVectors   borderFlux
+   , double         &dtCurrent
+){
+   auto dt        = dtCurrent;
+   auto dtIdeal   = double{0.0};
+   auto retval    = t_status{};
+
+   auto dtFirstStep  = dtCurrent;
+   auto dtSecondStep = dtMax;
+   auto dtFinalStep  = dtMax;
+
+   auto done = bool{false};
+
+   // First step: spatial integration, check for errors
+   retval = method->integrate( U, UL, borderFlux, dtIdeal );
+   if( retval.isError ){
+      retval.message += "\n! TimeIntegrationRK3Imex::step: (first) spatial integration";
+      return retval;
+   }
+   auto dtIdealFirst = dtIdeal;
+
+   // ideal time steps of the rows at the start of the step, which scale the operator per row
+   // in all stages; without them, all rows use the ideal time step of the grid
+   retval = method->getRowDtIdeal( U, rowDtIdeal );
+   if( retval.status == ReturnStatus::ErrorNotImplemented ){
+      rowDtIdeal.assign( nyTotal, dtIdealFirst );
+   } else if( retval.isError ){
+      retval.message += "\n! TimeIntegrationRK3Imex::step: row time steps";
+      return retval;
+   }
+
+   // First step: update time step, check for errors
+   retval = predictDt( dtFirstStep, dtIdeal );
+   if( retval.isError ){
+      retval.message += "\n! TimeIntegrationRK3Imex::step: (first) update time step";
+      return retval;
+   }
+
+   while( !done ){
+      dt = std::min({ dtFirstStep, dtSecondStep, dtFinalStep });
+      if( errorControl ){
+         dt = std::min( dt, dtError );
+         if( dt < dtMin ){
+            return { true, ReturnStatus::ErrorTimeUnderflow
+                   , std::string{} + "Error tolerance not satisfied!\n"
+                   + "Minimum time step = " + std::to_string(dtMin) + "\n"
+                   + "Target time step  = " + std::to_string(dt) + "\n"
+                   + "! TimeIntegrationRK3Imex::step" };
+         }
+      }
+
+      // First step: semi-implicit spatial derivative for this time step
+      setWeights( dt );
+      solveImplicit( UL, ULImplicit );
+
+      // First step: update variables, U1 = U + dt*ULImplicit;
+      // Second step: spatial integration, check for errors
+      auto firstStage = t_stageUpdate{ U, 1.0, nullptr, 0.0, ULImplicit, dt };
+      retval = method->integrateStage( firstStage, U1, ULStage, borderFlux1, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Imex::step: (second) spatial integration";
+         return retval;
+      }
+
+      // Second step: update time step, check for errors
+      retval = updateDt( dtSecondStep, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Imex::step: (second) update time step";
+         return retval;
+      }
+      if( rejectStep( dtSecondStep, dt ) ){
+         continue;
+      }
+      setWeights( dt*dtIdealFirst/dtIdeal );
+      solveImplicit( ULStage, ULStage );
+
+      // Second step: update variables in place, U1 = 3/4*U + 1/4*U1 + 1/4*dt*ULStage;
+      // Final step: spatial integration, check for errors
+      auto secondStage = t_stageUpdate{ U, 3.0/4.0, U1, 1.0/4.0, ULStage, (1.0/4.0)*dt };
+      retval = method->integrateStage( secondStage, U1, ULStage, borderFlux2, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Imex::step: (last) spatial integration";
+         return retval;
+      }
+
+      // Final step: update time step, check for errors
+      retval = updateDt( dtFinalStep, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Imex::step: (last) update time step";
+         return retval;
+      }
+      if( rejectStep( dtFinalStep, dt ) ){
+         continue;
+      }
+      setWeights( dt*dtIdealFirst/dtIdeal );
+      solveImplicit( ULStage, ULStage );
+
+      // Error control: compare the new state with the embedded second order solution
+      if( errorControl ){
+         TileResults errorResults{ scheduler->getThreadCount() };
+         scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t thread ){
+            auto error = double{0.0};
+            for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+               for( auto i = iFirst; i < iLast; i++ ){
+                  for( auto j = nyFirst; j < nyLast; j++ ){
+                     auto UNew = (1.0/3.0)*U[k][i][j] + (2.0/3.0)*U1[k][i][j] + (2.0/3.0)*dt*ULStage[k][i][j];
+                     auto UEmbedded = 2.0*U1[k][i][j] - U[k][i][j];
+                     error = std::max( error, scaledError( UNew - UEmbedded, U[k][i][j], UNew ) );
+                  }
+               }
+            }
+            errorResults.updateMax( thread, error );
+         } );
+
+         if( rejectStepError( errorResults.getMax(), dt, 3.0 ) ){
+            continue;
+         }
+      }
+
+      // Final step: update variables
+      scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            for( auto i = iFirst; i < iLast; i++ )
+               for( auto j = nyFirst; j < nyLast; j++ )
+                  U[k][i][j] = (1.0/3.0)*U[k][i][j] + (2.0/3.0)*U1[k][i][j] + (2.0/3.0)*dt*ULStage[k][i][j];
+      } );
+
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = nxFirst; i < nxLast; i++ ){
+            borderFlux.up[k][i]   = (1.0/6.0)*borderFlux.up[k][i]   + (1.0/6.0)*borderFlux1.up[k][i]   + (2.0/3.0)*borderFlux2.up[k][i];
+            borderFlux.down[k][i] = (1.0/6.0)*borderFlux.down[k][i] + (1.0/6.0)*borderFlux1.down[k][i] + (2.0/3.0)*borderFlux2.down[k][i];
+         }
+         for( auto j = nyFirst; j < nyLast; j++ ){
+            borderFlux.left[k][j]  = (1.0/6.0)*borderFlux.left[k][j]  + (1.0/6.0)*borderFlux1.left[k][j]  + (2.0/3.0)*borderFlux2.left[k][j];
+            borderFlux.right[k][j] = (1.0/6.0)*borderFlux.right[k][j] + (1.0/6.0)*borderFlux1.right[k][j] + (2.0/3.0)*borderFlux2.right[k][j];
+         }
+      }
+
+      done = true;
+   }
+
+   dtCurrent = dt;
+   method->getCharacteristicsX( cx, LUx );
+   method->getCharacteristicsY( cy, LUy );
+
+   // Everything OK
+   return { false, ReturnStatus::OK, "" };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Imex::solveImplicit
+   ( t_matrices  L
+   , t_matrices  X
+){
+   auto R = CG[0];   // residual
+   auto P = CG[1];   // search direction
+   auto Q = CG[2];   // operator applied to P
+   const auto twoDimensional = nyProblem > 1;
+
+   // ( I - D ) applied to the variable k of A at point (i,j)
+   auto apply = [&]( t_matrix A, size_t i, size_t j ){
+      auto d = weightX[j]*( A[i+1][j] + A[i-1][j] - 2.0*A[i][j] );
+      if( twoDimensional )
+         d += weightY[j]*( A[i][j+1] - A[i][j] ) + weightY[j-1]*( A[i][j-1] - A[i][j] );
+      return A[i][j] - d;
+   };
+
+   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+      // start from X = L, which is close for the waves resolved by dt: R = L - ( I - D ) L
+      if( X != L ){
+         scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+            for( auto i = iFirst; i < iLast; i++ )
+               for( auto j = nyFirst; j < nyLast; j++ )
+                  X[k][i][j] = L[k][i][j];
+         } );
+      }
+      applyBoundaries( X[k], k );
+      scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            auto sumLL = 0.0;
+            for( auto j = nyFirst; j < nyLast; j++ ){
+               R[i][j] = X[k][i][j] - apply( X[k], i, j );
+               P[i][j] = R[i][j];
+               sumLL  += X[k][i][j]*X[k][i][j];
+            }
+            columnSums[i] = sumLL;
+         }
+      } );
+      auto normL2 = sumColumns();
+      if( normL2 == 0.0 ){
+         continue;
+      }
+      scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            auto sumRR = 0.0;
+            for( auto j = nyFirst; j < nyLast; j++ )
+               sumRR += R[i][j]*R[i][j];
+            columnSums[i] = sumRR;
+         }
+      } );
+      auto rr = sumColumns();
+
+      solves++;
+      auto iteration = size_t{0};
+      for( ; iteration < maxIterations && rr > tolerance*tolerance*normL2; iteration++ ){
+         // Q = ( I - D ) P, step length along P
+         applyBoundaries( P, k );
+         scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+            for( auto i = iFirst; i < iLast; i++ ){
+               auto sumPQ = 0.0;
+               for( auto j = nyFirst; j < nyLast; j++ ){
+                  Q[i][j] = apply( P, i, j );
+                  sumPQ  += P[i][j]*Q[i][j];
+               }
+               columnSums[i] = sumPQ;
+            }
+         } );
+         auto alpha = rr/sumColumns();
+
+         // update solution and residual
+         scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+            for( auto i = iFirst; i < iLast; i++ ){
+               auto sumRR = 0.0;
+               for( auto j = nyFirst; j < nyLast; j++ ){
+                  X[k][i][j] += alpha*P[i][j];
+                  R[i][j]    -= alpha*Q[i][j];
+                  sumRR      += R[i][j]*R[i][j];
+               }
+               columnSums[i] = sumRR;
+            }
+         } );
+         auto rrNew = sumColumns();
+
+         // next search direction
+         auto beta = rrNew/rr;
+         rr = rrNew;
+         scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+            for( auto i = iFirst; i < iLast; i++ )
+               for( auto j = nyFirst; j < nyLast; j++ )
+                  P[i][j] = R[i][j] + beta*P[i][j];
+         } );
+      }
+
+      iterations += iteration;
+      if( rr > tolerance*tolerance*normL2 ){
+         if( solvesNotConverged == 0 ){
+            ERROUT << "WARNING: TimeIntegrationRK3Imex: Semi-implicit solve did not converge in "
+                   << maxIterations << " iterations.\n";
+         }
+         solvesNotConverged++;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Imex::setWeights
+   ( double dtScaled
+){
+   // per row, then the ghost rows like the variables
+   for( auto j = nyFirst; j < nyLast; j++ ){
+      auto sigma = dtScaled/rowDtIdeal[j];
+      weightX[j] = imexCoefficient*sigma*sigma;
+   }
+   if( mirrorBottom || boundary.bottom != BoundaryCondition::Periodic ){
+      weightX[nyFirst-1] = weightX[nyFirst];
+   } else {
+      weightX[nyFirst-1] = weightX[nyLast-1];
+   }
+   if( boundary.top != BoundaryCondition::Periodic ){
+      weightX[nyLast] = weightX[nyLast-1];
+   } else {
+      weightX[nyLast] = weightX[nyFirst];
+   }
+
+   // faces between rows j and j+1 take the larger weight of the two
+   for( auto j = nyFirst-1; j < nyLast; j++ ){
+      weightY[j] = std::max( weightX[j], weightX[j+1] );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Imex::applyBoundaries
+   ( t_matrix  X
+   , size_t    k
+){
+   // left and right
+   for( auto j = nyFirst; j < nyLast; j++ ){
+      switch( boundary.left ){
+      case BoundaryCondition::Periodic:
+         X[nxFirst-1][j] = X[nxLast-1][j];
+         break;
+      case BoundaryCondition::Dirichlet:
+         X[nxFirst-1][j] = 0.0;
+         break;
+      default:
+         X[nxFirst-1][j] = X[nxFirst][j];
+         break;
+      }
+      switch( boundary.right ){
+      case BoundaryCondition::Periodic:
+         X[nxLast][j] = X[nxFirst][j];
+         break;
+      case BoundaryCondition::Dirichlet:
+         X[nxLast][j] = 0.0;
+         break;
+      default:
+         X[nxLast][j] = X[nxLast-1][j];
+         break;
+      }
+   }
+
+   if( nyProblem == 1 ){
+      return;
+   }
+
+   // bottom and top; on a mirror plane, with the parity of the variable
+   for( auto i = nxFirst; i < nxLast; i++ ){
+      if( mirrorBottom ){
+         X[i][nyFirst-1] = MIRROR_PARITY_Y(k)*X[i][nyFirst];
+      } else switch( boundary.bottom ){
+      case BoundaryCondition::Periodic:
+         X[i][nyFirst-1] = X[i][nyLast-1];
+         break;
+      case BoundaryCondition::Dirichlet:
+         X[i][nyFirst-1] = 0.0;
+         break;
+      default:
+         X[i][nyFirst-1] = X[i][nyFirst];
+         break;
+      }
+      switch( boundary.top ){
+      case BoundaryCondition::Periodic:
+         X[i][nyLast] = X[i][nyFirst];
+         break;
+      case BoundaryCondition::Dirichlet:
+         X[i][nyLast] = 0.0;
+         break;
+      default:
+         X[i][nyLast] = X[i][nyLast-1];
+         break;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double TimeIntegrationRK3Imex::sumColumns
+   (
+){
+   auto sum = 0.0;
+   for( auto i = nxFirst; i < nxLast; i++ )
+      sum += columnSums[i];
+   return sum;
+}
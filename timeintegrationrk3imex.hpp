@@ -0,0 +1,119 @@
+#ifndef TIMEINTEGRATIONRK3IMEX_HPP
+#define TIMEINTEGRATIONRK3IMEX_HPP
+
+#include "timeintegrationmethod.hpp"
+
+// TVD RK3 with a semi-implicit treatment of the fast waves, for time steps larger than the
+// CFL condition of the fastest (fast magnetosonic) waves allows.
+//
+// After each spatial integration, the spatial derivative L of the stage is replaced by the
+// solution X of ( I - D ) X = L, where D is the undivided five-point Laplacian of the grid
+// indices, weighted in row j by c_j = imexCoefficient*(dt/dtIdeal_j)^2; dtIdeal_j is the time
+// step the CFL condition of row j allows for cfl number 1 at the start of the step, scaled in
+// the later stages with that of the grid. Faces between two rows take the larger weight. This
+// is the semi-implicit operator of D. S. Harned and D. D. Schnack, "Semi-implicit method for
+// long time scale magnetohydrodynamic computations in three dimensions", J. Comput. Phys. 65,
+// pp.57-70, 1986, in its isotropic form: it leaves the waves resolved by dt alone and slows
+// down, instead of amplifying, those that travel more than one grid point per step; the
+// dissipation of the flux splitting is limited the same way. Rows with slow waves, like a
+// current sheet between low beta lobes, are left nearly explicit. Space methods without the
+// row time steps use the time step of the grid for all rows.
+// The operator is symmetric positive definite, and is solved matrix-free with conjugate
+// gradients, per variable, with the ghost points set like the potential of the div B corrector.
+// With periodic and Neumann boundaries, the sums of the variables over the grid are kept.
+//
+// The time step may be up to cflFactor times that of the explicit method; the method stays
+// second order in time.
+class TimeIntegrationRK3Imex : public TimeIntegrationMethod
+{
+   public:
+      explicit TimeIntegrationRK3Imex( size_t nx
+                                     , size_t ny
+                                     , size_t bufferWidth
+                                     , double dtMin
+                                     , double dtMax
+                                     , double cflNumber
+                                     , std::unique_ptr<SpatialIntegrationMethod> method
+                                     , t_boundary   boundary
+                                     , bool         mirrorBottom
+                                     , double       cflFactor
+                                     , double       tolerance
+                                     , size_t       maxIterations
+                                     );
+      virtual ~TimeIntegrationRK3Imex();
+
+      t_status step( t_matrices     U
+                   , t_matrices     cx
+                   , t_matrices     cy
+                   , t_matrices     LUx
+                   , t_matrices     LUy
+                   , borderVectors  borderFlux
+                   , double        &dtCurrent
+                   ) override;
+
+      void printStatistics( std::ostream &out
+                          ) const override;
+
+      // coefficient of the semi-implicit operator, relative to (dt/dtIdeal)^2
+      static constexpr double imexCoefficient = 0.25;
+
+   protected:
+      void distributeMemory() override;
+
+      // Embedded second order solution 2*U2 - U (Heun's method)
+      bool hasErrorEstimate() const override;
+
+   private:
+      // Intermediate stages (the second stage is updated in place), the spatial derivative of
+      // the first stage, kept in case the time step is rejected, its semi-implicit version for
+      // the current time step, and the spatial derivative of the later stages
+      t_matrices U1;
+      t_matrices UL;
+      t_matrices ULImplicit;
+      t_matrices ULStage;
+
+      borderVectors borderFlux1;
+      borderVectors borderFlux2;
+
+      // boundaries of the semi-implicit operator
+      const t_boundary  boundary;
+      const bool        mirrorBottom;
+
+      // relative residual at which the conjugate gradients stop, and their iteration limit
+      const double      tolerance;
+      const size_t      maxIterations;
+
+      // residual, search direction and operator applied to it, for the conjugate gradients;
+      // per-column partial sums of the inner products
+      t_matrices        CG;
+      std::vector<double> columnSums;
+
+      // ideal time steps of the rows at the start of the step, and the weights of the operator
+      // for the faces in x-direction in row j, and in y-direction between rows j and j+1
+      std::vector<double> rowDtIdeal;
+      std::vector<double> weightX;
+      std::vector<double> weightY;
+
+      // solves, iterations, and solves that did not converge, over all steps
+      size_t solves               = 0;
+      size_t iterations           = 0;
+      size_t solvesNotConverged   = 0;
+
+      // Set the weights of the operator for time step dtScaled, relative to the ideal time
+      // steps of the rows
+      void setWeights( double dtScaled );
+
+      // Solve ( I - D ) X = L for all variables of X and L (which may be the same), with the
+      // weights of D set
+      void solveImplicit( t_matrices  L
+                        , t_matrices  X );
+
+      // Set the ghost points of variable k of X next to the grid, for the operator
+      void applyBoundaries( t_matrix  X
+                          , size_t    k );
+
+      // Sum of the per-column partial sums, in column order
+      double sumColumns();
+};
+
+#endif // TIMEINTEGRATIONRK3IMEX_HPP
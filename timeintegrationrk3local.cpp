@@ -0,0 +1,412 @@
+#include "timeintegrationrk3local.hpp"
+
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationRK3Local::TimeIntegrationRK3Local
+   ( size_t nx
+   , size_t ny
+   , size_t bufferWidth
+   , double dtMin
+   , double dtMax
+   , double cflNumber
+   , std::unique_ptr<SpatialIntegrationMethod> method
+   , const t_vector dyCell
+   , size_t bandCount
+   , size_t maxLevel
+   , bool   periodicY
+)
+   : TimeIntegrationMethod{ nx, ny, bufferWidth, dtMin, dtMax, cflNumber, std::move( method ) }
+   , dyInv( dyCell, dyCell+( ny+2*bufferWidth ) )
+   , bandCount{ bandCount }
+   , maxLevel{ maxLevel }
+   , periodicY{ periodicY }
+   , dtFast{ dtMax }
+   , rowUpdates{ 0.0 }
+   , rowUpdatesGlobal{ 0.0 }
+{
+   for( auto &d : dyInv ) d = 1.0/d;
+
+   UOld    = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   U0      = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   U1      = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   UL      = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   ULStage = createMatrices( PRB_DIM, nxTotal, nyTotal );
+
+   // bands of (nearly) equal height
+   for( auto b = size_t{0}; b <= bandCount; b++ ){
+      bandFirst.push_back( nyFirst + b*nyProblem/bandCount );
+   }
+   bandDtIdeal.assign( bandCount, 0.0 );
+   bandStageRatio.assign( bandCount, 1.0 );
+   rowBlock.assign( nyTotal, SIZE_MAX );
+
+   // two faces per block, at most one block per band
+   for( auto b = size_t{0}; b < 2*bandCount; b++ ){
+      fluxSums.push_back( createVectors( PRB_DIM, nxTotal ) );
+   }
+   faceFlux = createVectors( PRB_DIM, nxTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationRK3Local::~TimeIntegrationRK3Local
+   (
+){
+   freeMatrices( UOld );
+   freeMatrices( U0 );
+   freeMatrices( U1 );
+   freeMatrices( UL );
+   freeMatrices( ULStage );
+
+   for( auto flux : fluxSums ){
+      freeVectors( flux );
+   }
+   freeVectors( faceFlux );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Local::distributeMemory
+   (
+){
+   scheduler->distribute( UOld,    PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( U0,      PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( U1,      PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( UL,      PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( ULStage, PRB_DIM, nxTotal, nyTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Local::printStatistics
+   ( std::ostream &out
+) const {
+   TimeIntegrationMethod::printStatistics( out );
+   if( rowUpdatesGlobal > 0.0 ){
+      out << " - Local time stepping: " << 100.0*rowUpdates/rowUpdatesGlobal
+          << "% of the row updates of global time stepping\n";
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status TimeIntegrationRK3Local::step
+   ( t_matrices      U
+   , t_matrices      cx
+   , t_matrices      cy
+   , t_matrices      LUx
+   , t_matrices      LUy
+   , borderVectors   borderFlux
+   , double         &dtCurrent
+){
+   auto dt        = double{0.0};
+   auto retval    = t_status{};
+   auto rejected  = bool{true};
+
+   // keep the state at the start of the step; the stage arrays start from it, so that rows
+   // outside the current block always hold valid values
+   scheduler->forTiles( 0, nxTotal, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            for( auto j = size_t{0}; j < nyTotal; j++ ){
+               UOld[k][i][j] = U[k][i][j];
+               U0[k][i][j]   = U[k][i][j];
+               U1[k][i][j]   = U[k][i][j];
+            }
+         }
+      }
+   } );
+
+   // largest stable time step of each band, from its rows and the drop of dtIdeal within the
+   // stages of the previous step
+   method->setActiveRows( nyFirst, nyLast );
+   retval = method->getRowDtIdeal( U, rowDtIdeal );
+   if( retval.isError ){
+      retval.message += "\n! TimeIntegrationRK3Local::step: row time steps";
+      return retval;
+   }
+   for( auto b = size_t{0}; b < bandCount; b++ ){
+      auto dtIdeal = rowDtIdeal[bandFirst[b]];
+      for( auto j = bandFirst[b]; j < bandFirst[b+1]; j++ ){
+         dtIdeal = std::min( dtIdeal, rowDtIdeal[j] );
+      }
+      bandDtIdeal[b] = dtIdeal*bandStageRatio[b];
+   }
+
+   while( rejected ){
+      dt = assignLevels();
+      if( dt < dtMin ){
+         return { true, ReturnStatus::ErrorTimeUnderflow
+                , std::string{} + "CFL condition violated!\n"
+                + "Minimum time step = " + std::to_string(dtMin) + "\n"
+                + "Target time step  = " + std::to_string(dt) + "\n"
+                + "! TimeIntegrationRK3Local::step" };
+      }
+
+      retval = advance( U, borderFlux, dt, rejected );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Local::step";
+         return retval;
+      }
+
+      // restore the state and try again with the lowered band time steps
+      if( rejected ){
+         scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+            for( auto k = size_t{0}; k < PRB_DIM; k++ )
+               for( auto i = iFirst; i < iLast; i++ )
+                  for( auto j = nyFirst; j < nyLast; j++ )
+                     U[k][i][j] = UOld[k][i][j];
+         } );
+      }
+   }
+   method->setActiveRows( nyFirst, nyLast );
+
+   // expect the same drop of dtIdeal within the stages in the next step
+   for( const auto &block : blocks ){
+      for( auto b = size_t{0}; b < bandCount; b++ ){
+         if( bandFirst[b] >= block.first && bandFirst[b] < block.last ){
+            bandStageRatio[b] = block.dtIdealStageMin/block.dtIdealFirst;
+         }
+      }
+   }
+
+   // global time stepping would advance all rows with the time step of the fastest band
+   for( const auto &block : blocks ){
+      rowUpdates += double( (block.last-block.first) << block.level );
+   }
+   rowUpdatesGlobal += double( nyProblem )*dt/dtFast;
+
+   dtCurrent = dt;
+   method->getCharacteristicsX( cx, LUx );
+   method->getCharacteristicsY( cy, LUy );
+
+   // Everything OK
+   return { false, ReturnStatus::OK, "" };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double TimeIntegrationRK3Local::assignLevels
+   (
+){
+   // the fastest band advances with its largest stable time step, the slowest one with the
+   // largest power of two times that, up to maxLevel
+   auto dtSlow = double{0.0};
+   dtFast = dtMax;
+   for( auto b = size_t{0}; b < bandCount; b++ ){
+      dtSlow = std::max( dtSlow, cflNumber*bandDtIdeal[b] );
+      dtFast = std::min( dtFast, cflNumber*bandDtIdeal[b] );
+   }
+   auto dt = dtFast;
+   for( auto level = size_t{0}; level < maxLevel && 2.0*dt <= std::min( dtMax, dtSlow ); level++ ){
+      dt *= 2.0;
+   }
+
+   // each band on the first level that satisfies its CFL condition (up to round-off, as for
+   // the stages); neighbouring bands on the same level form one block
+   blocks.clear();
+   for( auto b = size_t{0}; b < bandCount; b++ ){
+      auto level = size_t{0};
+      while( level < maxLevel
+             && dt/double( size_t{1} << level ) > cflNumber*bandDtIdeal[b]*( 1.0 + dtStageTolerance ) ){
+         level++;
+      }
+
+      if( !blocks.empty() && blocks.back().level == level ){
+         blocks.back().last = bandFirst[b+1];
+      } else {
+         auto n = blocks.size();
+         blocks.push_back({ bandFirst[b], bandFirst[b+1], level, SIZE_MAX, SIZE_MAX
+                          , fluxSums[2*n], fluxSums[2*n+1], 0.0, 0.0 });
+      }
+   }
+
+   for( auto n = size_t{0}; n < blocks.size(); n++ ){
+      if( n > 0 ) blocks[n].lower = n-1;
+      if( n+1 < blocks.size() ) blocks[n].upper = n+1;
+      for( auto j = blocks[n].first; j < blocks[n].last; j++ ){
+         rowBlock[j] = n;
+      }
+   }
+   if( periodicY && blocks.size() > 1 ){
+      blocks.front().lower = blocks.size()-1;
+      blocks.back().upper  = 0;
+   }
+
+   return dt;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status TimeIntegrationRK3Local::advance
+   ( t_matrices      U
+   , borderVectors   borderFlux
+   , double          dt
+   , bool           &rejected
+){
+   auto dtIdeal   = double{0.0};
+   auto retval    = t_status{};
+
+   // order in which the blocks are advanced: coarse levels first
+   auto order = std::vector<size_t>( blocks.size(), 0 );
+   auto advanced = size_t{0};
+
+   // the time step of the block is rejected if a stage violates the CFL condition
+   auto rejectBlock = [&]( t_block &block, double dtLevel ){
+      if( block.dtIdealFirst == 0.0 ){
+         block.dtIdealFirst    = dtIdeal;
+         block.dtIdealStageMin = dtIdeal;
+      }
+      block.dtIdealStageMin = std::min( block.dtIdealStageMin, dtIdeal );
+      if( !rejectStep( cflNumber*dtIdeal, dtLevel ) ){
+         return false;
+      }
+      for( auto b = size_t{0}; b < bandCount; b++ ){
+         if( bandFirst[b] >= block.first && bandFirst[b] < block.last ){
+            bandDtIdeal[b] = std::min( bandDtIdeal[b], dtIdeal );
+         }
+      }
+      return true;
+   };
+
+   rejected = false;
+   for( auto level = size_t{0}; level <= maxLevel; level++ ){
+      for( auto b = size_t{0}; b < blocks.size(); b++ ){
+         auto &block = blocks[b];
+         if( block.level != level ) continue;
+
+         method->setActiveRows( block.first, block.last );
+         for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+            for( auto i = nxFirst; i < nxLast; i++ ){
+               block.fluxLower[k][i] = 0.0;
+               block.fluxUpper[k][i] = 0.0;
+            }
+         }
+
+         auto substeps = size_t{1} << level;
+         auto dtLevel  = dt/double( substeps );
+         for( auto s = size_t{0}; s < substeps; s++ ){
+            auto tStage = double( s )*dtLevel;
+
+            // First step: spatial integration of the block, with the neighbouring rows at t
+            scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+               for( auto k = size_t{0}; k < PRB_DIM; k++ )
+                  for( auto i = iFirst; i < iLast; i++ )
+                     for( auto j = block.first; j < block.last; j++ )
+                        U0[k][i][j] = U[k][i][j];
+            } );
+            setNeighbourRows( U0, U, b, tStage/dt );
+            retval = method->integrate( U0, UL, borderFlux, dtIdeal );
+            if( retval.isError ){
+               retval.message += "\n! TimeIntegrationRK3Local::advance: (first) spatial integration";
+               return retval;
+            }
+            if( rejectBlock( block, dtLevel ) ){
+               rejected = true;
+               return retval;
+            }
+            addFaceFluxes( b, (1.0/6.0)*dtLevel );
+
+            // First step: update variables, U1 = U0 + dt*UL, with the neighbouring rows at t+dt;
+            // Second step: spatial integration
+            setNeighbourRows( U1, U, b, (tStage+dtLevel)/dt );
+            auto firstStage = t_stageUpdate{ U0, 1.0, nullptr, 0.0, UL, dtLevel };
+            retval = method->integrateStage( firstStage, U1, ULStage, borderFlux, dtIdeal );
+            if( retval.isError ){
+               retval.message += "\n! TimeIntegrationRK3Local::advance: (second) spatial integration";
+               return retval;
+            }
+            if( rejectBlock( block, dtLevel ) ){
+               rejected = true;
+               return retval;
+            }
+            addFaceFluxes( b, (1.0/6.0)*dtLevel );
+
+            // Second step: update variables in place, U1 = 3/4*U0 + 1/4*U1 + 1/4*dt*ULStage, with
+            // the neighbouring rows at t+dt/2; Final step: spatial integration
+            setNeighbourRows( U1, U, b, (tStage+0.5*dtLevel)/dt );
+            auto secondStage = t_stageUpdate{ U0, 3.0/4.0, U1, 1.0/4.0, ULStage, (1.0/4.0)*dtLevel };
+            retval = method->integrateStage( secondStage, U1, ULStage, borderFlux, dtIdeal );
+            if( retval.isError ){
+               retval.message += "\n! TimeIntegrationRK3Local::advance: (last) spatial integration";
+               return retval;
+            }
+            if( rejectBlock( block, dtLevel ) ){
+               rejected = true;
+               return retval;
+            }
+            addFaceFluxes( b, (2.0/3.0)*dtLevel );
+
+            // Final step: update variables of the block
+            scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+               for( auto k = size_t{0}; k < PRB_DIM; k++ )
+                  for( auto i = iFirst; i < iLast; i++ )
+                     for( auto j = block.first; j < block.last; j++ )
+                        U[k][i][j] = (1.0/3.0)*U0[k][i][j] + (2.0/3.0)*U1[k][i][j] + (2.0/3.0)*dtLevel*ULStage[k][i][j];
+            } );
+         }
+
+         order[b] = advanced++;
+      }
+   }
+
+   // refluxing: at each face between blocks, the block advanced first takes the flux sum of
+   // the block advanced later
+   for( auto b = size_t{0}; b < blocks.size(); b++ ){
+      if( blocks[b].upper == SIZE_MAX ) continue;
+      const auto &lower = blocks[b];
+      const auto &upper = blocks[lower.upper];
+
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = nxFirst; i < nxLast; i++ ){
+            if( order[b] < order[lower.upper] ){
+               U[k][i][lower.last-1] -= dyInv[lower.last-1]*( upper.fluxLower[k][i] - lower.fluxUpper[k][i] );
+            } else {
+               U[k][i][upper.first]  += dyInv[upper.first]*( lower.fluxUpper[k][i] - upper.fluxLower[k][i] );
+            }
+         }
+      }
+   }
+
+   return retval;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Local::setNeighbourRows
+   ( t_matrices        V
+   , const t_matrices  U
+   , size_t            b
+   , double            theta
+){
+   const auto &block = blocks[b];
+
+   for( auto d = size_t{1}; d <= bufferWidth; d++ ){
+      for( auto j : { block.first-d, block.last-1+d } ){
+         // rows beyond the grid edge are filled by the boundary conditions, from the rows on
+         // the other side of the grid if the boundary is periodic
+         if( j < nyFirst || j >= nyLast ){
+            if( !periodicY ) continue;
+            j = j < nyFirst ? j+nyProblem : j-nyProblem;
+         }
+         if( rowBlock[j] == b ) continue;
+
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            for( auto i = nxFirst; i < nxLast; i++ )
+               V[k][i][j] = UOld[k][i][j] + theta*( U[k][i][j] - UOld[k][i][j] );
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Local::addFaceFluxes
+   ( size_t b
+   , double weight
+){
+   auto &block = blocks[b];
+
+   if( block.lower != SIZE_MAX && method->getFluxY( block.first-1, faceFlux ) ){
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         for( auto i = nxFirst; i < nxLast; i++ )
+            block.fluxLower[k][i] += weight*faceFlux[k][i];
+   }
+   if( block.upper != SIZE_MAX && method->getFluxY( block.last-1, faceFlux ) ){
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         for( auto i = nxFirst; i < nxLast; i++ )
+            block.fluxUpper[k][i] += weight*faceFlux[k][i];
+   }
+}
@@ -0,0 +1,125 @@
+#ifndef TIMEINTEGRATIONRK3LOCAL_HPP
+#define TIMEINTEGRATIONRK3LOCAL_HPP
+
+#include "timeintegrationmethod.hpp"
+
+// TVD RK3 with local time stepping: the grid is split into bands of rows, and each band is
+// advanced with its own time step dt/2^level, where dt is limited by the slowest band and the
+// level of a band by its own CFL condition.
+//
+// Neighbouring bands with the same level are advanced together as one block. Blocks are
+// advanced one after another, coarse levels first; the rows of a neighbouring block are
+// interpolated in time if that block has already been advanced, and frozen at the start of
+// the step otherwise. The numerical fluxes through the faces between blocks are accumulated
+// over all stages, and the block advanced first is corrected to the flux of the block advanced
+// later (refluxing), so the scheme stays conservative.
+//
+// Requires a spatial method that provides the numerical flux G and row-wise time steps.
+class TimeIntegrationRK3Local : public TimeIntegrationMethod
+{
+   public:
+      explicit TimeIntegrationRK3Local( size_t nx
+                                      , size_t ny
+                                      , size_t bufferWidth
+                                      , double dtMin
+                                      , double dtMax
+                                      , double cflNumber
+                                      , std::unique_ptr<SpatialIntegrationMethod> method
+                                      , const t_vector dyCell
+                                      , size_t bandCount
+                                      , size_t maxLevel
+                                      , bool   periodicY
+                                      );
+      virtual ~TimeIntegrationRK3Local();
+
+      t_status step( t_matrices     U
+                   , t_matrices     cx
+                   , t_matrices     cy
+                   , t_matrices     LUx
+                   , t_matrices     LUy
+                   , borderVectors  borderFlux
+                   , double        &dtCurrent
+                   ) override;
+
+      void printStatistics( std::ostream &out ) const override;
+
+   protected:
+      void distributeMemory() override;
+
+   private:
+      // Rows [first,last) advanced with time step dt/2^level; neighbouring blocks across the
+      // lower and upper face (SIZE_MAX if none), the fluxes through these faces, summed over
+      // all stages with their weights and time steps, and dtIdeal of the first and smallest
+      // dtIdeal of all stages
+      struct t_block {
+         size_t      first;
+         size_t      last;
+         size_t      level;
+         size_t      lower;
+         size_t      upper;
+         t_vectors   fluxLower;
+         t_vectors   fluxUpper;
+         double      dtIdealFirst;
+         double      dtIdealStageMin;
+      };
+
+      // inverse heights of the rows (including the ghost rows), for the flux corrections
+      std::vector<double> dyInv;
+      const size_t   bandCount;
+      const size_t   maxLevel;
+      const bool     periodicY;
+
+      // State at the start of the step, first stage (with the rows of neighbouring blocks),
+      // second and third stage, and spatial derivatives
+      t_matrices UOld;
+      t_matrices U0;
+      t_matrices U1;
+      t_matrices UL;
+      t_matrices ULStage;
+
+      // first row of each band (and the end of the last one), the largest stable time step of
+      // each band and row, the ratio of the smallest to the first dtIdeal of the stages of each
+      // band in the previous step, the blocks with the block of each row, and storage for the
+      // flux sums
+      std::vector<size_t>     bandFirst;
+      std::vector<double>     bandDtIdeal;
+      std::vector<double>     bandStageRatio;
+      std::vector<double>     rowDtIdeal;
+      std::vector<size_t>     rowBlock;
+      std::vector<t_block>    blocks;
+      std::vector<t_vectors>  fluxSums;
+      t_vectors               faceFlux;
+
+      // largest stable time step of the fastest band
+      double   dtFast;
+
+      // row updates, and the row updates the same steps would need with global time stepping
+      double   rowUpdates;
+      double   rowUpdatesGlobal;
+
+      // Time step of the step and levels of the bands; merges bands into blocks
+      double assignLevels();
+
+      // Advance the blocks by dt; returns true in rejected if a stage of a block violates the
+      // CFL condition, and lowers the time steps of its bands
+      t_status advance( t_matrices     U
+                      , borderVectors  borderFlux
+                      , double         dt
+                      , bool          &rejected
+                      );
+
+      // Fill the rows of neighbouring blocks within bufferWidth of block b in V with their
+      // values at t + theta*dt, interpolated between UOld and U (equal for blocks not advanced yet)
+      void setNeighbourRows( t_matrices        V
+                           , const t_matrices  U
+                           , size_t            b
+                           , double            theta
+                           );
+
+      // Add weight times the fluxes through the faces of block b to its sums
+      void addFaceFluxes( size_t b
+                        , double weight
+                        );
+};
+
+#endif // TIMEINTEGRATIONRK3LOCAL_HPP
@@ -0,0 +1,172 @@
+#include "timeintegrationrk3ls.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationRK3LowStorage::TimeIntegrationRK3LowStorage
+   ( size_t nx
+   , size_t ny
+   , size_t bufferWidth
+   , double dtMin
+   , double dtMax
+   , double cflNumber
+   , std::unique_ptr<SpatialIntegrationMethod> method
+)
+   : TimeIntegrationMethod{ nx, ny, bufferWidth, dtMin, dtMax, cflNumber, std::move( method ) }
+{
+   UR = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   UL = createMatrices( PRB_DIM, nxTotal, nyTotal );
+
+   borderFluxStage.left  = createVectors( PRB_DIM, nyTotal );
+   borderFluxStage.right = createVectors( PRB_DIM, nyTotal );
+   borderFluxStage.up    = createVectors( PRB_DIM, nxTotal );
+   borderFluxStage.down  = createVectors( PRB_DIM, nxTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationRK3LowStorage::~TimeIntegrationRK3LowStorage
+   (
+){
+   freeMatrices( UR );
+   freeMatrices( UL );
+
+   freeVectors( borderFluxStage.left  );
+   freeVectors( borderFluxStage.right );
+   freeVectors( borderFluxStage.up    );
+   freeVectors( borderFluxStage.down  );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3LowStorage::distributeMemory
+   (
+){
+   scheduler->distribute( UR, PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( UL, PRB_DIM, nxTotal, nyTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status TimeIntegrationRK3LowStorage::step
+   ( t_matrices      U
+   , t_matrices      cx
+   , t_matrices      cy
+   , t_matrices      LUx
+   , t_matrices      LUy
+   , borderVectors   borderFlux
+   , double         &dtCurrent
+){
+   auto dt        = dtCurrent;
+   auto dtIdeal   = double{0.0};
+   auto retval    = t_status{};
+
+   auto dtFirstStep  = dtCurrent;
+   auto dtSecondStep = dtMax;
+   auto dtFinalStep  = dtMax;
+
+   // UL holds the spatial derivative of U
+   auto haveFirstStep = bool{false};
+   auto firstEvaluation = bool{true};
+   auto done = bool{false};
+
+   while( !done ){
+      // First step: spatial integration, check for errors; UL is overwritten by the later
+      // stages, so it has to be recalculated if the time step was rejected
+      if( !haveFirstStep ){
+         retval = method->integrate( U, UL, borderFlux, dtIdeal );
+         if( retval.isError ){
+            retval.message += "\n! TimeIntegrationRK3LowStorage::step: (first) spatial integration";
+            return retval;
+         }
+
+         // First step: update time step, check for errors; a recalculation gives the same dtIdeal
+         if( firstEvaluation ){
+            retval = predictDt( dtFirstStep, dtIdeal );
+            if( retval.isError ){
+               retval.message += "\n! TimeIntegrationRK3LowStorage::step: (first) update time step";
+               return retval;
+            }
+            firstEvaluation = false;
+         }
+
+         haveFirstStep = true;
+      }
+
+      dt = std::min({ dtFirstStep, dtSecondStep, dtFinalStep });
+
+      // First step: update variables, UR = U + dt*UL;
+      // Second step: spatial integration, check for errors
+      auto firstStage = t_stageUpdate{ U, 1.0, nullptr, 0.0, UL, dt };
+      retval = method->integrateStage( firstStage, UR, UL, borderFluxStage, dtIdeal );
+      haveFirstStep = false;
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3LowStorage::step: (second) spatial integration";
+         return retval;
+      }
+
+      // Second step: update time step, check for errors
+      retval = updateDt( dtSecondStep, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3LowStorage::step: (second) update time step";
+         return retval;
+      }
+      if( rejectStep( dtSecondStep, dt ) ){
+         continue;
+      }
+
+      // Second step: accumulate border fluxes; borderFlux is recalculated if the time step is rejected
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = nxFirst; i < nxLast; i++ ){
+            borderFlux.up[k][i]   = (1.0/6.0)*borderFlux.up[k][i]   + (1.0/6.0)*borderFluxStage.up[k][i];
+            borderFlux.down[k][i] = (1.0/6.0)*borderFlux.down[k][i] + (1.0/6.0)*borderFluxStage.down[k][i];
+         }
+         for( auto j = nyFirst; j < nyLast; j++ ){
+            borderFlux.left[k][j]  = (1.0/6.0)*borderFlux.left[k][j]  + (1.0/6.0)*borderFluxStage.left[k][j];
+            borderFlux.right[k][j] = (1.0/6.0)*borderFlux.right[k][j] + (1.0/6.0)*borderFluxStage.right[k][j];
+         }
+      }
+
+      // Second step: update variables in place, UR = 3/4*U + 1/4*UR + 1/4*dt*UL;
+      // Final step: spatial integration, check for errors
+      auto secondStage = t_stageUpdate{ U, 3.0/4.0, UR, 1.0/4.0, UL, (1.0/4.0)*dt };
+      retval = method->integrateStage( secondStage, UR, UL, borderFluxStage, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3LowStorage::step: (last) spatial integration";
+         return retval;
+      }
+
+      // Final step: update time step, check for errors
+      retval = updateDt( dtFinalStep, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3LowStorage::step: (last) update time step";
+         return retval;
+      }
+      if( rejectStep( dtFinalStep, dt ) ){
+         continue;
+      }
+
+      // Final step: update variables
+      scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            for( auto i = iFirst; i < iLast; i++ )
+               for( auto j = nyFirst; j < nyLast; j++ )
+                  U[k][i][j] = (1.0/3.0)*U[k][i][j] + (2.0/3.0)*UR[k][i][j] + (2.0/3.0)*dt*UL[k][i][j];
+      } );
+
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = nxFirst; i < nxLast; i++ ){
+            borderFlux.up[k][i]   = borderFlux.up[k][i]   + (2.0/3.0)*borderFluxStage.up[k][i];
+            borderFlux.down[k][i] = borderFlux.down[k][i] + (2.0/3.0)*borderFluxStage.down[k][i];
+         }
+         for( auto j = nyFirst; j < nyLast; j++ ){
+            borderFlux.left[k][j]  = borderFlux.left[k][j]  + (2.0/3.0)*borderFluxStage.left[k][j];
+            borderFlux.right[k][j] = borderFlux.right[k][j] + (2.0/3.0)*borderFluxStage.right[k][j];
+         }
+      }
+
+      done = true;
+   }
+
+   dtCurrent = dt;
+   method->getCharacteristicsX( cx, LUx );
+   method->getCharacteristicsY( cy, LUy );
+
+   // Everything OK
+   return { false, ReturnStatus::OK, "" };
+}
@@ -0,0 +1,42 @@
+#ifndef TIMEINTEGRATIONRK3LS_HPP
+#define TIMEINTEGRATIONRK3LS_HPP
+
+#include "timeintegrationmethod.hpp"
+
+// Third order TVD Runge-Kutta method in low-storage form: the intermediate stages are
+// all kept in a single register, which is updated in place, and the spatial derivative
+// of the first stage is recalculated instead of kept when a time step is rejected, so
+// besides the solution only two extra grids are needed
+class TimeIntegrationRK3LowStorage : public TimeIntegrationMethod
+{
+   public:
+      explicit TimeIntegrationRK3LowStorage( size_t nx
+                                           , size_t ny
+                                           , size_t bufferWidth
+                                           , double dtMin
+                                           , double dtMax
+                                           , double cflNumber
+                                           , std::unique_ptr<SpatialIntegrationMethod> method
+                                           );
+      virtual ~TimeIntegrationRK3LowStorage();
+
+      t_status step( t_matrices     U
+                   , t_matrices     cx
+                   , t_matrices     cy
+                   , t_matrices      LUx
+                   , t_matrices      LUy
+                   , borderVectors  borderFlux
+                   , double        &dtCurrent
+                   ) override;
+
+   protected:
+      void distributeMemory() override;
+
+   private:
+      t_matrices UR;
+      t_matrices UL;
+
+      borderVectors borderFluxStage;
+};
+
+#endif // TIMEINTEGRATIONRK3LS_HPP
@@ -0,0 +1,608 @@
+#include "timeintegrationrk3refined.hpp"
+
+namespace {
+
+// Limited slope of a point from the differences to its neighbours
+double minmod
+   ( double a
+   , double b
+){
+   if( a*b <= 0.0 ) return 0.0;
+   return std::abs( a ) < std::abs( b ) ? a : b;
+}
+
+// Coarse index of fine index n of a grid with first interior index first; the fine points
+// 2m and 2m+1 after first lie on coarse point m after first
+size_t coarseIndex
+   ( size_t n
+   , size_t first
+){
+   auto offset = long( n ) - long( first );
+   return size_t( long( first ) + ( offset >= 0 ? offset/2 : -( (1-offset)/2 ) ) );
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationRK3Refined::TimeIntegrationRK3Refined
+   ( size_t nx
+   , size_t ny
+   , size_t bufferWidth
+   , double dtMin
+   , double dtMax
+   , double cflNumber
+   , std::unique_ptr<SpatialIntegrationMethod> method
+   , std::unique_ptr<SpatialIntegrationMethod> fineMethod
+   , double dy
+   , double gamma
+   , double threshold
+   , size_t marginRows
+   , size_t regridSteps
+)
+   : TimeIntegrationMethod{ nx, ny, bufferWidth, dtMin, dtMax, cflNumber, std::move( method ) }
+   , fineMethod{ std::move( fineMethod ) }
+   , dy{ dy }
+   , gamma{ gamma }
+   , threshold{ threshold }
+   , marginRows{ marginRows }
+   , regridSteps{ std::max( regridSteps, size_t{1} ) }
+   , nxFine{ 2*nx }
+   , nyFine{ 2*ny }
+   , nxTotalFine{ 2*nx+2*bufferWidth }
+   , nyTotalFine{ 2*ny+2*bufferWidth }
+   , patchFirst{ 0 }
+   , patchLast{ 0 }
+   , initialized{ false }
+   , stepCount{ 0 }
+   , pointUpdates{ 0.0 }
+   , pointUpdatesUniform{ 0.0 }
+{
+   UNew     = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   U1       = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   UL       = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   ULStage  = createMatrices( PRB_DIM, nxTotal, nyTotal );
+
+   UF       = createMatrices( PRB_DIM, nxTotalFine, nyTotalFine );
+   UFOld    = createMatrices( PRB_DIM, nxTotalFine, nyTotalFine );
+   UF0      = createMatrices( PRB_DIM, nxTotalFine, nyTotalFine );
+   UF1      = createMatrices( PRB_DIM, nxTotalFine, nyTotalFine );
+   ULF0     = createMatrices( PRB_DIM, nxTotalFine, nyTotalFine );
+   ULF      = createMatrices( PRB_DIM, nxTotalFine, nyTotalFine );
+   ULStageF = createMatrices( PRB_DIM, nxTotalFine, nyTotalFine );
+
+   // rows outside the patch are never integrated, but the boundary conditions still copy them
+   for( auto M : { UF, UFOld, UF0, UF1, ULF0, ULF, ULStageF } )
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         for( auto i = size_t{0}; i < nxTotalFine; i++ )
+            for( auto j = size_t{0}; j < nyTotalFine; j++ )
+               M[k][i][j] = 0.0;
+
+   fluxLower         = createVectors( PRB_DIM, nxTotal );
+   fluxUpper         = createVectors( PRB_DIM, nxTotal );
+   fluxLowerFirst    = createVectors( PRB_DIM, nxTotal );
+   fluxUpperFirst    = createVectors( PRB_DIM, nxTotal );
+   fluxLowerFine     = createVectors( PRB_DIM, nxTotal );
+   fluxUpperFine     = createVectors( PRB_DIM, nxTotal );
+   fluxLowerFineFirst = createVectors( PRB_DIM, nxTotal );
+   fluxUpperFineFirst = createVectors( PRB_DIM, nxTotal );
+   faceFlux          = createVectors( PRB_DIM, nxTotal );
+   faceFluxFine      = createVectors( PRB_DIM, nxTotalFine );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationRK3Refined::~TimeIntegrationRK3Refined
+   (
+){
+   freeMatrices( UNew );
+   freeMatrices( U1 );
+   freeMatrices( UL );
+   freeMatrices( ULStage );
+
+   freeMatrices( UF );
+   freeMatrices( UFOld );
+   freeMatrices( UF0 );
+   freeMatrices( UF1 );
+   freeMatrices( ULF0 );
+   freeMatrices( ULF );
+   freeMatrices( ULStageF );
+
+   freeVectors( fluxLower );
+   freeVectors( fluxUpper );
+   freeVectors( fluxLowerFirst );
+   freeVectors( fluxUpperFirst );
+   freeVectors( fluxLowerFine );
+   freeVectors( fluxUpperFine );
+   freeVectors( fluxLowerFineFirst );
+   freeVectors( fluxUpperFineFirst );
+   freeVectors( faceFlux );
+   freeVectors( faceFluxFine );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Refined::distributeMemory
+   (
+){
+   scheduler->distribute( UNew,     PRB_DIM, nxTotal,     nyTotal );
+   scheduler->distribute( U1,       PRB_DIM, nxTotal,     nyTotal );
+   scheduler->distribute( UL,       PRB_DIM, nxTotal,     nyTotal );
+   scheduler->distribute( ULStage,  PRB_DIM, nxTotal,     nyTotal );
+   scheduler->distribute( UF,       PRB_DIM, nxTotalFine, nyTotalFine );
+   scheduler->distribute( UFOld,    PRB_DIM, nxTotalFine, nyTotalFine );
+   scheduler->distribute( UF0,      PRB_DIM, nxTotalFine, nyTotalFine );
+   scheduler->distribute( UF1,      PRB_DIM, nxTotalFine, nyTotalFine );
+   scheduler->distribute( ULF0,     PRB_DIM, nxTotalFine, nyTotalFine );
+   scheduler->distribute( ULF,      PRB_DIM, nxTotalFine, nyTotalFine );
+   scheduler->distribute( ULStageF, PRB_DIM, nxTotalFine, nyTotalFine );
+
+   fineMethod->setScheduler( scheduler );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Refined::printStatistics
+   ( std::ostream &out
+) const {
+   TimeIntegrationMethod::printStatistics( out );
+   fineMethod->printStatistics( out );
+   if( pointUpdatesUniform > 0.0 ){
+      out << " - Refined patch      : " << 100.0*pointUpdates/pointUpdatesUniform
+          << "% of the point updates of a uniform fine grid, last patch at rows "
+          << int(patchFirst)-int(nyFirst) << " to " << int(patchLast)-int(nyFirst) << "\n";
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status TimeIntegrationRK3Refined::step
+   ( t_matrices      U
+   , t_matrices      cx
+   , t_matrices      cy
+   , t_matrices      LUx
+   , t_matrices      LUy
+   , borderVectors   borderFlux
+   , double         &dtCurrent
+){
+   auto dt        = dtCurrent;
+   auto dtIdeal   = double{0.0};
+   auto dtIdealFine = double{0.0};
+   auto retval    = t_status{};
+
+   auto dtFirstStep  = dtCurrent;
+   auto dtSecondStep = dtMax;
+   auto dtFinalStep  = dtMax;
+   auto dtFineStep   = dtMax;
+
+   auto done = bool{false};
+
+   // move the patch to the rows that currently need it
+   if( !initialized || stepCount%regridSteps == 0 ){
+      auto first = size_t{0}, last = size_t{0};
+      findPatch( U, first, last );
+      setPatch( U, first, last );
+   }
+   stepCount++;
+   auto refined = patchFirst < patchLast;
+   auto fineFirst = nyFirst + 2*( patchFirst-nyFirst );
+   auto fineLast  = nyFirst + 2*( patchLast-nyFirst );
+
+   // First step: spatial integration of both grids at t, check for errors
+   method->setActiveRows( nyFirst, nyLast );
+   retval = method->integrate( U, UL, borderFlux, dtIdeal );
+   if( retval.isError ){
+      retval.message += "\n! TimeIntegrationRK3Refined::step: (first) spatial integration";
+      return retval;
+   }
+   if( refined ){
+      method->getFluxY( patchFirst-1, fluxLowerFirst );
+      method->getFluxY( patchLast-1, fluxUpperFirst );
+
+      // the state at the start of the step is the first stage of the first substep, and is
+      // kept for repeated attempts
+      scheduler->forTiles( nxFirst, nxFirst+nxFine, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            for( auto i = iFirst; i < iLast; i++ )
+               for( auto j = fineFirst; j < fineLast; j++ )
+                  UFOld[k][i][j] = UF[k][i][j];
+      } );
+      setHaloRows( UF0, U, 0.0 );
+      fineMethod->setActiveRows( fineFirst, fineLast );
+      auto copyStage = t_stageUpdate{ UFOld, 1.0, nullptr, 0.0, ULF0, 0.0 };
+      retval = fineMethod->integrateStage( copyStage, UF0, ULF0, borderFlux, dtIdealFine );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Refined::step: (first) fine spatial integration";
+         return retval;
+      }
+      fineMethod->getFluxY( fineFirst-1, faceFluxFine );
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         for( auto i = nxFirst; i < nxLast; i++ )
+            fluxLowerFineFirst[k][i] = 0.5*( faceFluxFine[k][2*i-nxFirst] + faceFluxFine[k][2*i-nxFirst+1] );
+      fineMethod->getFluxY( fineLast-1, faceFluxFine );
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         for( auto i = nxFirst; i < nxLast; i++ )
+            fluxUpperFineFirst[k][i] = 0.5*( faceFluxFine[k][2*i-nxFirst] + faceFluxFine[k][2*i-nxFirst+1] );
+
+      // the fine grid advances with dt/2
+      dtIdeal = std::min( dtIdeal, 2.0*dtIdealFine );
+   }
+
+   // First step: update time step, check for errors
+   retval = predictDt( dtFirstStep, dtIdeal );
+   if( retval.isError ){
+      retval.message += "\n! TimeIntegrationRK3Refined::step: (first) update time step";
+      return retval;
+   }
+
+   while( !done ){
+      dt = std::min({ dtFirstStep, dtSecondStep, dtFinalStep, dtFineStep });
+      method->setActiveRows( nyFirst, nyLast );
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = nxFirst; i < nxLast; i++ ){
+            fluxLower[k][i] = (1.0/6.0)*dt*fluxLowerFirst[k][i];
+            fluxUpper[k][i] = (1.0/6.0)*dt*fluxUpperFirst[k][i];
+         }
+      }
+
+      // First step: update variables, U1 = U + dt*UL;
+      // Second step: spatial integration, check for errors
+      auto firstStage = t_stageUpdate{ U, 1.0, nullptr, 0.0, UL, dt };
+      retval = method->integrateStage( firstStage, U1, ULStage, borderFlux, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Refined::step: (second) spatial integration";
+         return retval;
+      }
+
+      // Second step: update time step, check for errors
+      retval = updateDt( dtSecondStep, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Refined::step: (second) update time step";
+         return retval;
+      }
+      if( rejectStep( dtSecondStep, dt ) ){
+         continue;
+      }
+      addFaceFluxes( false, (1.0/6.0)*dt );
+
+      // Second step: update variables in place, U1 = 3/4*U + 1/4*U1 + 1/4*dt*ULStage;
+      // Final step: spatial integration, check for errors
+      auto secondStage = t_stageUpdate{ U, 3.0/4.0, U1, 1.0/4.0, ULStage, (1.0/4.0)*dt };
+      retval = method->integrateStage( secondStage, U1, ULStage, borderFlux, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Refined::step: (last) spatial integration";
+         return retval;
+      }
+
+      // Final step: update time step, check for errors
+      retval = updateDt( dtFinalStep, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Refined::step: (last) update time step";
+         return retval;
+      }
+      if( rejectStep( dtFinalStep, dt ) ){
+         continue;
+      }
+      addFaceFluxes( false, (2.0/3.0)*dt );
+
+      // Final step: new coarse state, kept apart from U until the fine substeps are done
+      scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            for( auto i = iFirst; i < iLast; i++ )
+               for( auto j = nyFirst; j < nyLast; j++ )
+                  UNew[k][i][j] = (1.0/3.0)*U[k][i][j] + (2.0/3.0)*U1[k][i][j] + (2.0/3.0)*dt*ULStage[k][i][j];
+      } );
+
+      // Fine substeps, with the rows next to the patch interpolated between U and UNew
+      if( refined ){
+         auto rejected = bool{false};
+         retval = advanceFine( U, borderFlux, dt, dtFineStep, rejected );
+         if( retval.isError ){
+            retval.message += "\n! TimeIntegrationRK3Refined::step";
+            return retval;
+         }
+         if( rejected ){
+            continue;
+         }
+      }
+
+      done = true;
+   }
+
+   // accept the step: coarse state, coarse rows under the patch from the fine points, and
+   // refluxing of the coarse rows next to it
+   scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto i = iFirst; i < iLast; i++ ){
+            for( auto j = nyFirst; j < nyLast; j++ ){
+               U[k][i][j] = UNew[k][i][j];
+            }
+            if( !refined ) continue;
+
+            auto iF = 2*i-nxFirst;
+            for( auto j = patchFirst; j < patchLast; j++ ){
+               auto jF = 2*j-nyFirst;
+               U[k][i][j] = 0.25*( UF[k][iF][jF] + UF[k][iF+1][jF] + UF[k][iF][jF+1] + UF[k][iF+1][jF+1] );
+            }
+            U[k][i][patchFirst-1] -= (1.0/dy)*( fluxLowerFine[k][i] - fluxLower[k][i] );
+            U[k][i][patchLast]    += (1.0/dy)*( fluxUpperFine[k][i] - fluxUpper[k][i] );
+         }
+      }
+   } );
+
+   pointUpdates        += double( nxProblem*nyProblem ) + 2.0*double( nxFine*( fineLast-fineFirst ) );
+   pointUpdatesUniform += 2.0*double( nxFine*nyFine );
+
+   dtCurrent = dt;
+   method->getCharacteristicsX( cx, LUx );
+   method->getCharacteristicsY( cy, LUy );
+
+   // Everything OK
+   return { false, ReturnStatus::OK, "" };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status TimeIntegrationRK3Refined::advanceFine
+   ( const t_matrices  U
+   , borderVectors     borderFlux
+   , double            dt
+   , double           &dtFineStep
+   , bool             &rejected
+){
+   auto dtIdealFine = double{0.0};
+   auto retval      = t_status{};
+   auto dtFine      = 0.5*dt;
+   auto fineFirst   = nyFirst + 2*( patchFirst-nyFirst );
+   auto fineLast    = nyFirst + 2*( patchLast-nyFirst );
+
+   // the fine stages advance with dt/2, so they allow twice their ideal time step
+   auto checkFine = [&](){
+      auto status = updateDt( dtFineStep, 2.0*dtIdealFine );
+      if( status.isError ){
+         status.message += "\n! TimeIntegrationRK3Refined::advanceFine: update time step";
+         return status;
+      }
+      rejected = rejectStep( dtFineStep, dt );
+      return t_status{ false, ReturnStatus::OK, "" };
+   };
+
+   fineMethod->setActiveRows( fineFirst, fineLast );
+   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+      for( auto i = nxFirst; i < nxLast; i++ ){
+         fluxLowerFine[k][i] = (1.0/6.0)*dtFine*fluxLowerFineFirst[k][i];
+         fluxUpperFine[k][i] = (1.0/6.0)*dtFine*fluxUpperFineFirst[k][i];
+      }
+   }
+
+   rejected = false;
+   for( auto s = size_t{0}; s < 2; s++ ){
+      auto theta = 0.5*double( s );
+      auto UBase = UFOld;
+      auto LBase = ULF0;
+
+      // First step: spatial integration at the start of the substep (done by step for the
+      // first substep)
+      if( s > 0 ){
+         UBase = UF0;
+         LBase = ULF;
+         setHaloRows( UF0, U, theta );
+         auto copyStage = t_stageUpdate{ UF, 1.0, nullptr, 0.0, ULF, 0.0 };
+         retval = fineMethod->integrateStage( copyStage, UF0, ULF, borderFlux, dtIdealFine );
+         if( retval.isError ){
+            retval.message += "\n! TimeIntegrationRK3Refined::advanceFine: (first) spatial integration";
+            return retval;
+         }
+         retval = checkFine();
+         if( retval.isError || rejected ){
+            return retval;
+         }
+         addFaceFluxes( true, (1.0/6.0)*dtFine );
+      }
+
+      // First step: update variables, UF1 = UBase + dt*LBase; Second step: spatial integration
+      setHaloRows( UF1, U, theta+0.5 );
+      auto firstStage = t_stageUpdate{ UBase, 1.0, nullptr, 0.0, LBase, dtFine };
+      retval = fineMethod->integrateStage( firstStage, UF1, ULStageF, borderFlux, dtIdealFine );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Refined::advanceFine: (second) spatial integration";
+         return retval;
+      }
+      retval = checkFine();
+      if( retval.isError || rejected ){
+         return retval;
+      }
+      addFaceFluxes( true, (1.0/6.0)*dtFine );
+
+      // Second step: update variables in place, UF1 = 3/4*UBase + 1/4*UF1 + 1/4*dt*ULStageF;
+      // Final step: spatial integration
+      setHaloRows( UF1, U, theta+0.25 );
+      auto secondStage = t_stageUpdate{ UBase, 3.0/4.0, UF1, 1.0/4.0, ULStageF, (1.0/4.0)*dtFine };
+      retval = fineMethod->integrateStage( secondStage, UF1, ULStageF, borderFlux, dtIdealFine );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationRK3Refined::advanceFine: (last) spatial integration";
+         return retval;
+      }
+      retval = checkFine();
+      if( retval.isError || rejected ){
+         return retval;
+      }
+      addFaceFluxes( true, (2.0/3.0)*dtFine );
+
+      // Final step: update variables of the patch
+      scheduler->forTiles( nxFirst, nxFirst+nxFine, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            for( auto i = iFirst; i < iLast; i++ )
+               for( auto j = fineFirst; j < fineLast; j++ )
+                  UF[k][i][j] = (1.0/3.0)*UBase[k][i][j] + (2.0/3.0)*UF1[k][i][j] + (2.0/3.0)*dtFine*ULStageF[k][i][j];
+      } );
+   }
+
+   return retval;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Refined::findPatch
+   ( const t_matrices  U
+   , size_t           &first
+   , size_t           &last
+) const {
+   // pressure and |B| of a point
+   auto pressure = [&]( size_t i, size_t j ){
+      auto mm = U[1][i][j]*U[1][i][j] + U[2][i][j]*U[2][i][j] + U[3][i][j]*U[3][i][j];
+      auto bb = U[4][i][j]*U[4][i][j] + U[5][i][j]*U[5][i][j] + U[6][i][j]*U[6][i][j];
+      return (gamma-1.0)*( U[7][i][j] - 0.5*mm/U[0][i][j] - 0.5*bb );
+   };
+   auto field = [&]( size_t i, size_t j ){
+      return std::sqrt( U[4][i][j]*U[4][i][j] + U[5][i][j]*U[5][i][j] + U[6][i][j]*U[6][i][j] );
+   };
+
+   // |B| may vanish (at the centre of a current sheet), so its changes are relative to its
+   // maximum over the grid
+   auto bMax = double{0.0};
+   for( auto i = nxFirst; i < nxLast; i++ )
+      for( auto j = nyFirst; j < nyLast; j++ )
+         bMax = std::max( bMax, field( i, j ) );
+
+   auto changes = [&]( size_t i1, size_t j1, size_t i2, size_t j2 ){
+      auto r1 = U[0][i1][j1], r2 = U[0][i2][j2];
+      auto p1 = pressure( i1, j1 ), p2 = pressure( i2, j2 );
+      return std::abs( r2-r1 ) > threshold*0.5*( std::abs( r1 )+std::abs( r2 ) )
+          || std::abs( p2-p1 ) > threshold*0.5*( std::abs( p1 )+std::abs( p2 ) )
+          || std::abs( field( i2, j2 )-field( i1, j1 ) ) > threshold*bMax;
+   };
+
+   auto flaggedFirst = nyLast, flaggedLast = nyFirst;
+   for( auto j = nyFirst; j < nyLast; j++ ){
+      for( auto i = nxFirst; i < nxLast; i++ ){
+         auto flagged = ( i+1 < nxLast && changes( i, j, i+1, j ) )
+                     || ( j+1 < nyLast && changes( i, j, i, j+1 ) );
+         if( flagged ){
+            flaggedFirst = std::min( flaggedFirst, j );
+            flaggedLast  = std::max( flaggedLast, j+2 );
+            break;
+         }
+      }
+   }
+   flaggedLast = std::min( flaggedLast, nyLast );
+
+   // the rows next to the patch are prolonged from the coarse grid, with slopes from the
+   // rows beyond them, so both have to be interior rows
+   auto haloRows = ( bufferWidth+1 )/2 + 1;
+   if( flaggedFirst >= flaggedLast || nyProblem < 2*haloRows+1 ){
+      first = last = 0;
+      return;
+   }
+   first = flaggedFirst > nyFirst+haloRows+marginRows ? flaggedFirst-marginRows : nyFirst+haloRows;
+   last  = std::min( flaggedLast+marginRows, nyLast-haloRows );
+   if( first >= last ){
+      first = last = 0;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Refined::setPatch
+   ( const t_matrices  U
+   , size_t            first
+   , size_t            last
+){
+   if( !initialized ){
+      // whole fine grid, including the ghost cells for the Dirichlet boundaries
+      prolongRows( UF, U, U, 0.0, 0, nyTotalFine, true );
+      fineMethod->initializeDirichletBoundaries( UF );
+      initialized = true;
+   } else {
+      // rows that were not refined so far; the others keep their fine values
+      for( auto j = first; j < last; j++ ){
+         if( j >= patchFirst && j < patchLast ) continue;
+         auto jF = 2*j-nyFirst;
+         prolongRows( UF, U, U, 0.0, jF, jF+2, false );
+      }
+   }
+
+   patchFirst = first;
+   patchLast  = last;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Refined::setHaloRows
+   ( t_matrices        V
+   , const t_matrices  U
+   , double            theta
+) const {
+   auto fineFirst = nyFirst + 2*( patchFirst-nyFirst );
+   auto fineLast  = nyFirst + 2*( patchLast-nyFirst );
+
+   prolongRows( V, U, UNew, theta, fineFirst-bufferWidth, fineFirst, true );
+   prolongRows( V, U, UNew, theta, fineLast, fineLast+bufferWidth, true );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Refined::prolongRows
+   ( t_matrices        V
+   , const t_matrices  UA
+   , const t_matrices  UB
+   , double            theta
+   , size_t            first
+   , size_t            last
+   , bool              withGhosts
+) const {
+   auto iFirst = withGhosts ? size_t{0} : nxFirst;
+   auto iLast  = withGhosts ? nxTotalFine : nxFirst+nxFine;
+
+   auto interior = [&]( size_t i, size_t j ){
+      return i >= nxFirst && i < nxLast && j >= nyFirst && j < nyLast;
+   };
+   // coarse state at t + theta*dt; UB only has interior points, the ghost cells are taken
+   // from UA, and slopes only from interior points
+   auto coarse = [&]( size_t k, size_t i, size_t j ){
+      return theta == 0.0 || !interior( i, j ) ? UA[k][i][j] : UA[k][i][j] + theta*( UB[k][i][j] - UA[k][i][j] );
+   };
+
+   scheduler->forTiles( iFirst, iLast, [&]( size_t tileFirst, size_t tileLast, size_t /*thread*/ ){
+      for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+         for( auto iF = tileFirst; iF < tileLast; iF++ ){
+            auto i = coarseIndex( iF, nxFirst );
+            auto sx = ( iF-nxFirst )%2 == 0 ? -0.25 : 0.25;
+            for( auto jF = first; jF < last; jF++ ){
+               auto j = coarseIndex( jF, nyFirst );
+               auto sy = ( jF-nyFirst )%2 == 0 ? -0.25 : 0.25;
+
+               auto c = coarse( k, i, j );
+               auto slopeX = double{0.0}, slopeY = double{0.0};
+               if( interior( i-1, j ) && interior( i+1, j ) ){
+                  slopeX = minmod( coarse( k, i+1, j ) - c, c - coarse( k, i-1, j ) );
+               }
+               if( interior( i, j-1 ) && interior( i, j+1 ) ){
+                  slopeY = minmod( coarse( k, i, j+1 ) - c, c - coarse( k, i, j-1 ) );
+               }
+               V[k][iF][jF] = c + sx*slopeX + sy*slopeY;
+            }
+         }
+      }
+   } );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationRK3Refined::addFaceFluxes
+   ( bool   fine
+   , double weight
+){
+   if( !fine ){
+      method->getFluxY( patchFirst-1, faceFlux );
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         for( auto i = nxFirst; i < nxLast; i++ )
+            fluxLower[k][i] += weight*faceFlux[k][i];
+      method->getFluxY( patchLast-1, faceFlux );
+      for( auto k = size_t{0}; k < PRB_DIM; k++ )
+         for( auto i = nxFirst; i < nxLast; i++ )
+            fluxUpper[k][i] += weight*faceFlux[k][i];
+      return;
+   }
+
+   // a coarse face covers two fine faces
+   auto fineFirst = nyFirst + 2*( patchFirst-nyFirst );
+   auto fineLast  = nyFirst + 2*( patchLast-nyFirst );
+   fineMethod->getFluxY( fineFirst-1, faceFluxFine );
+   for( auto k = size_t{0}; k < PRB_DIM; k++ )
+      for( auto i = nxFirst; i < nxLast; i++ )
+         fluxLowerFine[k][i] += weight*0.5*( faceFluxFine[k][2*i-nxFirst] + faceFluxFine[k][2*i-nxFirst+1] );
+   fineMethod->getFluxY( fineLast-1, faceFluxFine );
+   for( auto k = size_t{0}; k < PRB_DIM; k++ )
+      for( auto i = nxFirst; i < nxLast; i++ )
+         fluxUpperFine[k][i] += weight*0.5*( faceFluxFine[k][2*i-nxFirst] + faceFluxFine[k][2*i-nxFirst+1] );
+}
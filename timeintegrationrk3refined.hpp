@@ -0,0 +1,157 @@
+#ifndef TIMEINTEGRATIONRK3REFINED_HPP
+#define TIMEINTEGRATIONRK3REFINED_HPP
+
+#include "timeintegrationmethod.hpp"
+
+// TVD RK3 with a refined patch: the rows where rho, p or |B| change by more than a relative
+// threshold between neighbouring points (plus a margin) are covered by a patch with half the
+// grid spacing in both directions, which is advanced with two substeps of dt/2 per step of the
+// coarse grid.
+//
+// The patch spans the whole grid in x, so it only has coarse-fine faces at its bottom and top.
+// The coarse grid is advanced first; the fine rows within bufferWidth of the patch are then
+// prolonged from the coarse grid (linear with minmod-limited slopes, so that the fine points
+// average to the coarse point) and interpolated in time. After the substeps, the coarse rows
+// under the patch are replaced by the averages of the fine points, and the coarse rows next to
+// it are corrected to the fine fluxes through the coarse-fine faces (refluxing), so the scheme
+// stays conservative. The patch is moved every regridSteps steps; newly covered rows are
+// prolonged from the coarse grid.
+//
+// The fine method integrates a grid of 2*nx x 2*ny points with spacing dx/2, dy/2, and has to
+// provide the numerical flux G; only the rows of the patch are integrated.
+class TimeIntegrationRK3Refined : public TimeIntegrationMethod
+{
+   public:
+      explicit TimeIntegrationRK3Refined( size_t nx
+                                        , size_t ny
+                                        , size_t bufferWidth
+                                        , double dtMin
+                                        , double dtMax
+                                        , double cflNumber
+                                        , std::unique_ptr<SpatialIntegrationMethod> method
+                                        , std::unique_ptr<SpatialIntegrationMethod> fineMethod
+                                        , double dy
+                                        , double gamma
+                                        , double threshold
+                                        , size_t marginRows
+                                        , size_t regridSteps
+                                        );
+      virtual ~TimeIntegrationRK3Refined();
+
+      t_status step( t_matrices     U
+                   , t_matrices     cx
+                   , t_matrices     cy
+                   , t_matrices     LUx
+                   , t_matrices     LUy
+                   , borderVectors  borderFlux
+                   , double        &dtCurrent
+                   ) override;
+
+      void printStatistics( std::ostream &out ) const override;
+
+   protected:
+      void distributeMemory() override;
+
+   private:
+      std::unique_ptr<SpatialIntegrationMethod> fineMethod;
+
+      const double   dy;
+      const double   gamma;
+      const double   threshold;
+      const size_t   marginRows;
+      const size_t   regridSteps;
+
+      // size of the fine grid
+      const size_t   nxFine;
+      const size_t   nyFine;
+      const size_t   nxTotalFine;
+      const size_t   nyTotalFine;
+
+      // Coarse grid: state at the end of the step, intermediate stages and spatial derivatives
+      t_matrices UNew;
+      t_matrices U1;
+      t_matrices UL;
+      t_matrices ULStage;
+
+      // Fine grid: state, state at the start of the step, first and second stage, spatial
+      // derivative at the start of the step and of the substeps
+      t_matrices UF;
+      t_matrices UFOld;
+      t_matrices UF0;
+      t_matrices UF1;
+      t_matrices ULF0;
+      t_matrices ULF;
+      t_matrices ULStageF;
+
+      // coarse rows [patchFirst,patchLast) of the patch, empty if nothing is refined
+      size_t   patchFirst;
+      size_t   patchLast;
+      bool     initialized;
+      size_t   stepCount;
+
+      // coarse and fine fluxes through the bottom and top face of the patch, summed over all
+      // stages with their weights and time steps, the fluxes at the start of the step (kept
+      // for repeated attempts), and storage for the fluxes of a stage
+      t_vectors fluxLower;
+      t_vectors fluxUpper;
+      t_vectors fluxLowerFirst;
+      t_vectors fluxUpperFirst;
+      t_vectors fluxLowerFine;
+      t_vectors fluxUpperFine;
+      t_vectors fluxLowerFineFirst;
+      t_vectors fluxUpperFineFirst;
+      t_vectors faceFlux;
+      t_vectors faceFluxFine;
+
+      // point updates of both grids, and those of a uniform fine grid in the same time
+      double   pointUpdates;
+      double   pointUpdatesUniform;
+
+      // Coarse rows to refine, from the relative changes of rho, p and |B| in U
+      void findPatch( const t_matrices  U
+                    , size_t           &first
+                    , size_t           &last
+                    ) const;
+
+      // Fill fine rows [first,last) in V from the coarse state UA + theta*( UB - UA ); ghost
+      // columns are included if withGhosts is true
+      void prolongRows( t_matrices        V
+                      , const t_matrices  UA
+                      , const t_matrices  UB
+                      , double            theta
+                      , size_t            first
+                      , size_t            last
+                      , bool              withGhosts
+                      ) const;
+
+      // Fill the fine rows within bufferWidth of the patch in V at t + theta*dt, with their ghost
+      // columns
+      void setHaloRows( t_matrices        V
+                      , const t_matrices  U
+                      , double            theta
+                      ) const;
+
+      // Move the patch to the rows [first,last), prolonging newly covered rows from U
+      void setPatch( const t_matrices  U
+                   , size_t            first
+                   , size_t            last
+                   );
+
+      // Add weight times the fluxes through the coarse-fine faces of the coarse (fine is
+      // false) or fine grid to their sums
+      void addFaceFluxes( bool   fine
+                        , double weight
+                        );
+
+      // Advance the fine patch by two substeps of dt/2, from UFOld and ULF0 at the start of the
+      // step. Returns true in rejected if a stage needs a time step below dt, which is then
+      // set in dtFineStep
+      t_status advanceFine( const t_matrices  U
+                          , borderVectors     borderFlux
+                          , double            dt
+                          , double           &dtFineStep
+                          , bool             &rejected
+                          );
+};
+
+#endif // TIMEINTEGRATIONRK3REFINED_HPP
@@ -0,0 +1,195 @@
+#include "timeintegrationssprk43.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationSSPRK43::TimeIntegrationSSPRK43
+   ( size_t nx
+   , size_t ny
+   , size_t bufferWidth
+   , double dtMin
+   , double dtMax
+   , double cflNumber
+   , std::unique_ptr<SpatialIntegrationMethod> method
+)
+   : TimeIntegrationMethod{ nx, ny, bufferWidth, dtMin, dtMax, cflNumber, std::move( method ) }
+{
+   sspCoefficient = 2.0;
+
+   U1      = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   UL      = createMatrices( PRB_DIM, nxTotal, nyTotal );
+   ULStage = createMatrices( PRB_DIM, nxTotal, nyTotal );
+
+   borderFluxStage.left  = createVectors( PRB_DIM, nyTotal );
+   borderFluxStage.right = createVectors( PRB_DIM, nyTotal );
+   borderFluxStage.up    = createVectors( PRB_DIM, nxTotal );
+   borderFluxStage.down  = createVectors( PRB_DIM, nxTotal );
+   borderFluxSum.left    = createVectors( PRB_DIM, nyTotal );
+   borderFluxSum.right   = createVectors( PRB_DIM, nyTotal );
+   borderFluxSum.up      = createVectors( PRB_DIM, nxTotal );
+   borderFluxSum.down    = createVectors( PRB_DIM, nxTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TimeIntegrationSSPRK43::~TimeIntegrationSSPRK43
+   (
+){
+   freeMatrices( U1 );
+   freeMatrices( UL );
+   freeMatrices( ULStage );
+
+   freeVectors( borderFluxStage.left  );
+   freeVectors( borderFluxStage.right );
+   freeVectors( borderFluxStage.up    );
+   freeVectors( borderFluxStage.down  );
+   freeVectors( borderFluxSum.left    );
+   freeVectors( borderFluxSum.right   );
+   freeVectors( borderFluxSum.up      );
+   freeVectors( borderFluxSum.down    );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationSSPRK43::distributeMemory
+   (
+){
+   scheduler->distribute( U1,      PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( UL,      PRB_DIM, nxTotal, nyTotal );
+   scheduler->distribute( ULStage, PRB_DIM, nxTotal, nyTotal );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void TimeIntegrationSSPRK43::combineBorderFlux
+   ( borderVectors   out
+   , double          a
+   , borderVectors   in1
+   , double          b
+   , borderVectors   in2
+){
+   for( auto k = size_t{0}; k < PRB_DIM; k++ ){
+      for( auto i = nxFirst; i < nxLast; i++ ){
+         out.up[k][i]   = a*in1.up[k][i]   + b*in2.up[k][i];
+         out.down[k][i] = a*in1.down[k][i] + b*in2.down[k][i];
+      }
+      for( auto j = nyFirst; j < nyLast; j++ ){
+         out.left[k][j]  = a*in1.left[k][j]  + b*in2.left[k][j];
+         out.right[k][j] = a*in1.right[k][j] + b*in2.right[k][j];
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_status TimeIntegrationSSPRK43::step
+   ( t_matrices      U
+   , t_matrices      cx
+   , t_matrices      cy
+   , t_matrices      LUx
+   , t_matrices      LUy
+   , borderVectors   borderFlux
+   , double         &dtCurrent
+){
+   auto dt        = dtCurrent;
+   auto dtIdeal   = double{0.0};
+   auto retval    = t_status{};
+
+   auto dtFirstStep  = dtCurrent;
+   auto dtSecondStep = dtMax;
+   auto dtThirdStep  = dtMax;
+   auto dtFinalStep  = dtMax;
+
+   auto done = bool{false};
+
+   // First step: spatial integration, check for errors
+   retval = method->integrate( U, UL, borderFlux, dtIdeal );
+   if( retval.isError ){
+      retval.message += "\n! TimeIntegrationSSPRK43::step: (first) spatial integration";
+      return retval;
+   }
+
+   // First step: update time step, check for errors
+   retval = predictDt( dtFirstStep, dtIdeal );
+   if( retval.isError ){
+      retval.message += "\n! TimeIntegrationSSPRK43::step: (first) update time step";
+      return retval;
+   }
+
+   while( !done ){
+      dt = std::min({ dtFirstStep, dtSecondStep, dtThirdStep, dtFinalStep });
+
+      // First step: update variables, U1 = U + 1/2*dt*UL;
+      // Second step: spatial integration, check for errors
+      auto firstStage = t_stageUpdate{ U, 1.0, nullptr, 0.0, UL, (1.0/2.0)*dt };
+      retval = method->integrateStage( firstStage, U1, ULStage, borderFluxStage, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationSSPRK43::step: (second) spatial integration";
+         return retval;
+      }
+
+      // Second step: update time step, check for errors
+      retval = updateDt( dtSecondStep, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationSSPRK43::step: (second) update time step";
+         return retval;
+      }
+      if( rejectStep( dtSecondStep, dt ) ){
+         continue;
+      }
+      combineBorderFlux( borderFluxSum, 1.0/6.0, borderFlux, 1.0/6.0, borderFluxStage );
+
+      // Second step: update variables in place, U1 = U1 + 1/2*dt*ULStage;
+      // Third step: spatial integration, check for errors
+      auto secondStage = t_stageUpdate{ U1, 1.0, nullptr, 0.0, ULStage, (1.0/2.0)*dt };
+      retval = method->integrateStage( secondStage, U1, ULStage, borderFluxStage, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationSSPRK43::step: (third) spatial integration";
+         return retval;
+      }
+
+      // Third step: update time step, check for errors
+      retval = updateDt( dtThirdStep, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationSSPRK43::step: (third) update time step";
+         return retval;
+      }
+      if( rejectStep( dtThirdStep, dt ) ){
+         continue;
+      }
+      combineBorderFlux( borderFluxSum, 1.0, borderFluxSum, 1.0/6.0, borderFluxStage );
+
+      // Third step: update variables in place, U1 = 2/3*U + 1/3*U1 + 1/6*dt*ULStage;
+      // Final step: spatial integration, check for errors
+      auto thirdStage = t_stageUpdate{ U, 2.0/3.0, U1, 1.0/3.0, ULStage, (1.0/6.0)*dt };
+      retval = method->integrateStage( thirdStage, U1, ULStage, borderFluxStage, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationSSPRK43::step: (last) spatial integration";
+         return retval;
+      }
+
+      // Final step: update time step, check for errors
+      retval = updateDt( dtFinalStep, dtIdeal );
+      if( retval.isError ){
+         retval.message += "\n! TimeIntegrationSSPRK43::step: (last) update time step";
+         return retval;
+      }
+      if( rejectStep( dtFinalStep, dt ) ){
+         continue;
+      }
+
+      // Final step: update variables
+      scheduler->forTiles( nxFirst, nxLast, [&]( size_t iFirst, size_t iLast, size_t /*thread*/ ){
+         for( auto k = size_t{0}; k < PRB_DIM; k++ )
+            for( auto i = iFirst; i < iLast; i++ )
+               for( auto j = nyFirst; j < nyLast; j++ )
+                  U[k][i][j] = U1[k][i][j] + (1.0/2.0)*dt*ULStage[k][i][j];
+      } );
+
+      // The stages contribute 1/6, 1/6, 1/6 and 1/2 of dt*L to the final update
+      combineBorderFlux( borderFlux, 1.0, borderFluxSum, 1.0/2.0, borderFluxStage );
+
+      done = true;
+   }
+
+   dtCurrent = dt;
+   method->getCharacteristicsX( cx, LUx );
+   method->getCharacteristicsY( cy, LUy );
+
+   // Everything OK
+   return { false, ReturnStatus::OK, "" };
+}
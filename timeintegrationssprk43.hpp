@@ -0,0 +1,53 @@
+#ifndef TIMEINTEGRATIONSSPRK43_HPP
+#define TIMEINTEGRATIONSSPRK43_HPP
+
+#include "timeintegrationmethod.hpp"
+
+// Four stage, third order strong stability preserving Runge-Kutta method SSPRK(4,3);
+// its SSP coefficient is 2, so it advances 2/4 of the time step allowed for an Euler step
+// per spatial integration, compared to 1/3 for the three stage TVD RK3
+class TimeIntegrationSSPRK43 : public TimeIntegrationMethod
+{
+   public:
+      explicit TimeIntegrationSSPRK43( size_t nx
+                                     , size_t ny
+                                     , size_t bufferWidth
+                                     , double dtMin
+                                     , double dtMax
+                                     , double cflNumber
+                                     , std::unique_ptr<SpatialIntegrationMethod> method
+                                     );
+      virtual ~TimeIntegrationSSPRK43();
+
+      t_status step( t_matrices     U
+                   , t_matrices     cx
+                   , t_matrices     cy
+                   , t_matrices      LUx
+                   , t_matrices      LUy
+                   , borderVectors  borderFlux
+                   , double        &dtCurrent
+                   ) override;
+
+   protected:
+      void distributeMemory() override;
+
+   private:
+      // Intermediate stages (updated in place), the spatial derivative of the first stage,
+      // kept in case the time step is rejected, and of the later stages
+      t_matrices U1;
+      t_matrices UL;
+      t_matrices ULStage;
+
+      borderVectors borderFluxStage;
+      borderVectors borderFluxSum;
+
+      // out = a*in1 + b*in2 along the borders
+      void combineBorderFlux( borderVectors  out
+                            , double         a
+                            , borderVectors  in1
+                            , double         b
+                            , borderVectors  in2
+                            );
+};
+
+#endif // TIMEINTEGRATIONSSPRK43_HPP
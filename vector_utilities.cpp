@@ -97,6 +97,25 @@ t_matrices createMatrices
    return mm;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+t_matrices createMatricesView
+   ( t_matrices mm
+   , int n
+   , int sizeX
+   , int offsetY
+){
+   t_matrices view;
+   view = (t_matrices)malloc( n*sizeof(*view) );
+   t_matrix m;
+   m = (t_matrix)malloc( n*sizeX*sizeof(*m) );
+   for( int k = 0; k < n; k++ ){
+      view[k] = m + k*sizeX;
+      for( int i = 0; i < sizeX; i++ )
+         view[k][i] = mm[k][i] + offsetY;
+   }
+   return view;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void freeMatrices
    ( t_matrices mm
@@ -109,3 +128,13 @@ void freeMatrices
       free( mm );
    }
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void freeMatricesView
+   ( t_matrices mm
+){
+   if( mm ){
+      if( mm[0] ) free( mm[0] );
+      free( mm );
+   }
+}
@@ -28,6 +28,14 @@ t_matrices createMatrices
    , int sizeX
    , int sizeY );
 
+// group of matrices sharing the data of mm, with column j of the view at column
+// j+offsetY of mm; free with freeMatricesView
+t_matrices createMatricesView
+   ( t_matrices mm
+   , int n
+   , int sizeX
+   , int offsetY );
+
 // free
 void freeVector
    ( t_vector v );
@@ -41,4 +49,7 @@ void freeMatrix
 void freeMatrices
    ( t_matrices mm );
 
+void freeMatricesView
+   ( t_matrices mm );
+
 #endif // VECTOR_UTILITIES_HPP_INCLUDED